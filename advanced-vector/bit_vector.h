@@ -0,0 +1,280 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "vector.h"
+
+// Вектор битов, упакованных в 64-битные слова. Все слова в пределах ёмкости
+// проинициализированы, а биты за пределами размера равны нулю, поэтому Count
+// и побитовые операции работают целыми словами без маскирования хвоста.
+class BitVector {
+ public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  class Reference {
+   public:
+    Reference(uint64_t* word, uint64_t mask) noexcept
+        : word_(word), mask_(mask) {}
+    Reference(const Reference&) = default;
+
+    operator bool() const noexcept { return (*word_ & mask_) != 0; }
+    Reference& operator=(bool value) noexcept {
+      if (value) {
+        *word_ |= mask_;
+      } else {
+        *word_ &= ~mask_;
+      }
+      return *this;
+    }
+    Reference& operator=(const Reference& other) noexcept {
+      return *this = static_cast<bool>(other);
+    }
+    void Flip() noexcept { *word_ ^= mask_; }
+
+   private:
+    uint64_t* word_;
+    uint64_t mask_;
+  };
+
+  BitVector() = default;
+  explicit BitVector(size_t size, bool value = false);
+  BitVector(const BitVector& other);
+  BitVector(BitVector&& other) noexcept;
+  BitVector& operator=(const BitVector& rhs);
+  BitVector& operator=(BitVector&& rhs) noexcept;
+
+  size_t Size() const noexcept;
+  size_t Capacity() const noexcept;
+  Reference operator[](size_t index) noexcept;
+  bool operator[](size_t index) const noexcept;
+  void Reserve(size_t new_capacity);
+  void Resize(size_t new_size, bool value = false);
+  void PushBack(bool value);
+  void PopBack() noexcept;
+  void Swap(BitVector& other) noexcept;
+
+  // Количество установленных битов
+  size_t Count() const noexcept;
+  // Индекс первого установленного бита либо npos
+  size_t FindFirst() const noexcept;
+  // Индекс первого установленного бита не меньше from либо npos
+  size_t FindNext(size_t from) const noexcept;
+
+  // Побитовые операции над векторами одинакового размера выполняются словами
+  BitVector& operator&=(const BitVector& rhs) noexcept;
+  BitVector& operator|=(const BitVector& rhs) noexcept;
+  BitVector& operator^=(const BitVector& rhs) noexcept;
+
+  const uint64_t* Words() const noexcept;
+  size_t WordCount() const noexcept;
+
+ private:
+  static constexpr size_t kWordBits = 64;
+
+  static size_t WordsFor(size_t bits) noexcept;
+  static uint64_t Mask(size_t index) noexcept;
+  void ReallocateWords(size_t new_word_capacity);
+  void ClearTail() noexcept;
+
+  RawMemory<uint64_t> words_;
+  size_t size_ = 0;
+};
+
+inline BitVector::BitVector(size_t size, bool value) {
+  Resize(size, value);
+}
+
+inline BitVector::BitVector(const BitVector& other)
+    : words_{WordsFor(other.size_)}, size_{other.size_} {
+  std::uninitialized_copy_n(other.words_.GetAddress(), words_.Capacity(),
+                            words_.GetAddress());
+}
+
+inline BitVector::BitVector(BitVector&& other) noexcept {
+  Swap(other);
+}
+
+inline BitVector& BitVector::operator=(const BitVector& rhs) {
+  if (this != &rhs) {
+    BitVector rhs_copy(rhs);
+    Swap(rhs_copy);
+  }
+  return *this;
+}
+
+inline BitVector& BitVector::operator=(BitVector&& rhs) noexcept {
+  if (this != &rhs) {
+    Swap(rhs);
+  }
+  return *this;
+}
+
+inline size_t BitVector::Size() const noexcept {
+  return size_;
+}
+
+inline size_t BitVector::Capacity() const noexcept {
+  return words_.Capacity() * kWordBits;
+}
+
+inline BitVector::Reference BitVector::operator[](size_t index) noexcept {
+  assert(index < size_);
+  return {&words_[index / kWordBits], Mask(index)};
+}
+
+inline bool BitVector::operator[](size_t index) const noexcept {
+  assert(index < size_);
+  return (words_[index / kWordBits] & Mask(index)) != 0;
+}
+
+inline void BitVector::Reserve(size_t new_capacity) {
+  if (new_capacity > Capacity()) {
+    ReallocateWords(WordsFor(new_capacity));
+  }
+}
+
+inline void BitVector::Resize(size_t new_size, bool value) {
+  if (new_size > size_) {
+    if (new_size > Capacity()) {
+      ReallocateWords(std::max(WordsFor(new_size), words_.Capacity() * 2));
+    }
+    const size_t old_size = size_;
+    size_ = new_size;
+    if (value) {
+      // Добиваем текущее слово побитно, остальные заполняем целиком
+      size_t index = old_size;
+      for (; index < new_size && index % kWordBits != 0; ++index) {
+        words_[index / kWordBits] |= Mask(index);
+      }
+      std::fill(words_ + WordsFor(index), words_ + WordsFor(new_size),
+                ~uint64_t{0});
+      ClearTail();
+    }
+  } else {
+    const size_t old_words = WordsFor(size_);
+    size_ = new_size;
+    ClearTail();
+    std::fill(words_ + WordsFor(new_size), words_ + old_words, uint64_t{0});
+  }
+}
+
+inline void BitVector::PushBack(bool value) {
+  if (size_ == Capacity()) {
+    ReallocateWords(words_.Capacity() == 0 ? 1 : words_.Capacity() * 2);
+  }
+  if (value) {
+    words_[size_ / kWordBits] |= Mask(size_);
+  }
+  ++size_;
+}
+
+inline void BitVector::PopBack() noexcept {
+  assert(size_ != 0);
+  --size_;
+  words_[size_ / kWordBits] &= ~Mask(size_);
+}
+
+inline void BitVector::Swap(BitVector& other) noexcept {
+  words_.Swap(other.words_);
+  std::swap(size_, other.size_);
+}
+
+inline size_t BitVector::Count() const noexcept {
+  size_t count = 0;
+  for (size_t i = 0, n = WordsFor(size_); i < n; ++i) {
+    count += __builtin_popcountll(words_[i]);
+  }
+  return count;
+}
+
+inline size_t BitVector::FindFirst() const noexcept {
+  return FindNext(0);
+}
+
+inline size_t BitVector::FindNext(size_t from) const noexcept {
+  if (from >= size_) {
+    return npos;
+  }
+  size_t word_index = from / kWordBits;
+  uint64_t word = words_[word_index] & (~uint64_t{0} << (from % kWordBits));
+  for (const size_t n = WordsFor(size_); word == 0;) {
+    if (++word_index == n) {
+      return npos;
+    }
+    word = words_[word_index];
+  }
+  return word_index * kWordBits + __builtin_ctzll(word);
+}
+
+inline BitVector& BitVector::operator&=(const BitVector& rhs) noexcept {
+  assert(size_ == rhs.size_);
+  for (size_t i = 0, n = WordsFor(size_); i < n; ++i) {
+    words_[i] &= rhs.words_[i];
+  }
+  return *this;
+}
+
+inline BitVector& BitVector::operator|=(const BitVector& rhs) noexcept {
+  assert(size_ == rhs.size_);
+  for (size_t i = 0, n = WordsFor(size_); i < n; ++i) {
+    words_[i] |= rhs.words_[i];
+  }
+  return *this;
+}
+
+inline BitVector& BitVector::operator^=(const BitVector& rhs) noexcept {
+  assert(size_ == rhs.size_);
+  for (size_t i = 0, n = WordsFor(size_); i < n; ++i) {
+    words_[i] ^= rhs.words_[i];
+  }
+  return *this;
+}
+
+inline const uint64_t* BitVector::Words() const noexcept {
+  return words_.GetAddress();
+}
+
+inline size_t BitVector::WordCount() const noexcept {
+  return WordsFor(size_);
+}
+
+inline size_t BitVector::WordsFor(size_t bits) noexcept {
+  return (bits + kWordBits - 1) / kWordBits;
+}
+
+inline uint64_t BitVector::Mask(size_t index) noexcept {
+  return uint64_t{1} << (index % kWordBits);
+}
+
+inline void BitVector::ReallocateWords(size_t new_word_capacity) {
+  RawMemory<uint64_t> new_words{new_word_capacity};
+  const size_t used = WordsFor(size_);
+  std::uninitialized_copy_n(words_.GetAddress(), used, new_words.GetAddress());
+  std::uninitialized_fill(new_words + used, new_words + new_word_capacity,
+                          uint64_t{0});
+  words_.Swap(new_words);
+}
+
+inline void BitVector::ClearTail() noexcept {
+  if (size_ % kWordBits != 0) {
+    words_[size_ / kWordBits] &= Mask(size_) - 1;
+  }
+}
+
+inline BitVector operator&(BitVector lhs, const BitVector& rhs) noexcept {
+  lhs &= rhs;
+  return lhs;
+}
+
+inline BitVector operator|(BitVector lhs, const BitVector& rhs) noexcept {
+  lhs |= rhs;
+  return lhs;
+}
+
+inline BitVector operator^(BitVector lhs, const BitVector& rhs) noexcept {
+  lhs ^= rhs;
+  return lhs;
+}
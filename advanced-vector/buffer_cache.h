@@ -0,0 +1,226 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace buffer_cache_detail {
+
+inline constexpr size_t kMaxClass = 20;  // 1 МиБ
+inline constexpr size_t kNumClasses = kMaxClass + 1;
+inline constexpr size_t kThreadSlots = 8;
+inline constexpr size_t kDepotSlots = 64;
+
+struct Stats {
+  size_t hits = 0;
+  size_t misses = 0;
+};
+
+template <size_t Slots>
+struct FreeLists {
+  std::array<std::array<void*, Slots>, kNumClasses> buffers{};
+  std::array<size_t, kNumClasses> counts{};
+};
+
+struct ThreadCache : FreeLists<kThreadSlots> {
+  ~ThreadCache();
+
+  size_t bytes = 0;
+  Stats stats;
+};
+
+struct Depot : FreeLists<kDepotSlots> {
+  ~Depot();
+
+  std::mutex mutex;
+};
+
+}  // namespace buffer_cache_detail
+
+// Кэш буферов RawMemory. Включается вызовом BufferCache::SetEnabled(true);
+// в выключенном состоянии память выделяется и освобождается напрямую через
+// operator new/delete. Включать и выключать кэш можно в любой момент.
+//
+// Размеры до 1 МиБ округляются вверх до степени двойки (классы размеров), в
+// том числе при выключенном кэше: буфер, выделенный до включения, может
+// попасть в кэш при освобождении и должен вмещать свой класс. Освобождённые
+// буферы попадают в локальный кэш потока с ограниченным числом буферов на
+// класс и общим объёмом. Излишки переносятся в общий склад под мьютексом,
+// откуда их забирают другие потоки, поэтому буфер, выделенный в одном потоке
+// и освобождённый в другом, возвращается в оборот, а не копится у
+// освободившего. При завершении потока его кэш сдаётся на склад.
+class BufferCache {
+ public:
+  using Stats = buffer_cache_detail::Stats;
+
+  static void SetEnabled(bool enabled) noexcept;
+  static bool IsEnabled() noexcept;
+
+  static void* Allocate(size_t bytes);
+  static void Deallocate(void* buffer, size_t bytes) noexcept;
+
+  // Статистика попаданий текущего потока
+  static Stats ThreadStats() noexcept;
+  // Возвращает системе буферы из кэша текущего потока и со склада
+  static void Trim() noexcept;
+
+ private:
+  using ThreadCache = buffer_cache_detail::ThreadCache;
+  using Depot = buffer_cache_detail::Depot;
+  friend ThreadCache;
+
+  static constexpr size_t kMaxClass = buffer_cache_detail::kMaxClass;
+  static constexpr size_t kNumClasses = buffer_cache_detail::kNumClasses;
+  static constexpr size_t kThreadSlots = buffer_cache_detail::kThreadSlots;
+  static constexpr size_t kThreadMaxBytes = size_t{4} << 20;
+  static constexpr size_t kDepotSlots = buffer_cache_detail::kDepotSlots;
+
+  static size_t CeilClass(size_t bytes) noexcept;
+  static ThreadCache* LocalCache() noexcept;
+  static void PushToDepot(ThreadCache& cache, size_t size_class,
+                          size_t count) noexcept;
+  static size_t PullFromDepot(ThreadCache& cache, size_t size_class) noexcept;
+
+  static inline std::atomic<bool> enabled_{false};
+  static inline Depot depot_;
+  static inline thread_local ThreadCache thread_cache_;
+  // Тривиально разрушаемый флаг, по которому видно, что кэш потока уже
+  // уничтожен (например, при разрушении статических векторов)
+  static inline thread_local bool thread_cache_alive_ = true;
+};
+
+inline void BufferCache::SetEnabled(bool enabled) noexcept {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+inline bool BufferCache::IsEnabled() noexcept {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+inline void* BufferCache::Allocate(size_t bytes) {
+  if (bytes > (size_t{1} << kMaxClass)) {
+    return operator new(bytes);
+  }
+  const size_t size_class = CeilClass(bytes);
+  if (!IsEnabled()) {
+    return operator new(size_t{1} << size_class);
+  }
+  ThreadCache* cache = LocalCache();
+  if (cache != nullptr) {
+    if (cache->counts[size_class] != 0 ||
+        PullFromDepot(*cache, size_class) != 0) {
+      ++cache->stats.hits;
+      cache->bytes -= size_t{1} << size_class;
+      return cache->buffers[size_class][--cache->counts[size_class]];
+    }
+    ++cache->stats.misses;
+  }
+  return operator new(size_t{1} << size_class);
+}
+
+inline void BufferCache::Deallocate(void* buffer, size_t bytes) noexcept {
+  if (buffer == nullptr) {
+    return;
+  }
+  // Пока кэш выключен, локальный кэш потока не создаётся: обращение к нему
+  // конструирует thread_local и регистрирует его деструктор
+  if (!IsEnabled() || bytes > (size_t{1} << kMaxClass)) {
+    operator delete(buffer);
+    return;
+  }
+  ThreadCache* cache = LocalCache();
+  if (cache == nullptr) {
+    operator delete(buffer);
+    return;
+  }
+  const size_t size_class = CeilClass(bytes);
+  const size_t class_bytes = size_t{1} << size_class;
+  if (cache->counts[size_class] == kThreadSlots ||
+      cache->bytes + class_bytes > kThreadMaxBytes) {
+    PushToDepot(*cache, size_class, (cache->counts[size_class] + 1) / 2);
+  }
+  if (cache->counts[size_class] == kThreadSlots ||
+      cache->bytes + class_bytes > kThreadMaxBytes) {
+    operator delete(buffer);
+    return;
+  }
+  cache->buffers[size_class][cache->counts[size_class]++] = buffer;
+  cache->bytes += class_bytes;
+}
+
+inline BufferCache::Stats BufferCache::ThreadStats() noexcept {
+  ThreadCache* cache = LocalCache();
+  return cache != nullptr ? cache->stats : Stats{};
+}
+
+inline void BufferCache::Trim() noexcept {
+  if (ThreadCache* cache = LocalCache()) {
+    for (size_t size_class = 0; size_class < kNumClasses; ++size_class) {
+      while (cache->counts[size_class] != 0) {
+        operator delete(cache->buffers[size_class][--cache->counts[size_class]]);
+      }
+    }
+    cache->bytes = 0;
+  }
+  std::lock_guard guard(depot_.mutex);
+  for (size_t size_class = 0; size_class < kNumClasses; ++size_class) {
+    while (depot_.counts[size_class] != 0) {
+      operator delete(depot_.buffers[size_class][--depot_.counts[size_class]]);
+    }
+  }
+}
+
+inline buffer_cache_detail::ThreadCache::~ThreadCache() {
+  BufferCache::thread_cache_alive_ = false;
+  for (size_t size_class = 0; size_class < kNumClasses; ++size_class) {
+    if (counts[size_class] != 0) {
+      BufferCache::PushToDepot(*this, size_class, counts[size_class]);
+    }
+  }
+}
+
+inline buffer_cache_detail::Depot::~Depot() {
+  for (size_t size_class = 0; size_class < kNumClasses; ++size_class) {
+    while (counts[size_class] != 0) {
+      operator delete(buffers[size_class][--counts[size_class]]);
+    }
+  }
+}
+
+inline size_t BufferCache::CeilClass(size_t bytes) noexcept {
+  return bytes <= 1 ? 0 : 64 - __builtin_clzll(bytes - 1);
+}
+
+inline BufferCache::ThreadCache* BufferCache::LocalCache() noexcept {
+  return thread_cache_alive_ ? &thread_cache_ : nullptr;
+}
+
+inline void BufferCache::PushToDepot(ThreadCache& cache, size_t size_class,
+                                     size_t count) noexcept {
+  std::lock_guard guard(depot_.mutex);
+  for (; count != 0; --count) {
+    void* buffer = cache.buffers[size_class][--cache.counts[size_class]];
+    cache.bytes -= size_t{1} << size_class;
+    if (depot_.counts[size_class] == kDepotSlots) {
+      operator delete(buffer);
+    } else {
+      depot_.buffers[size_class][depot_.counts[size_class]++] = buffer;
+    }
+  }
+}
+
+inline size_t BufferCache::PullFromDepot(ThreadCache& cache,
+                                         size_t size_class) noexcept {
+  std::lock_guard guard(depot_.mutex);
+  size_t count = 0;
+  const size_t class_bytes = size_t{1} << size_class;
+  while (count < kThreadSlots / 2 && depot_.counts[size_class] != 0 &&
+         cache.bytes + class_bytes <= kThreadMaxBytes) {
+    cache.buffers[size_class][cache.counts[size_class]++] =
+        depot_.buffers[size_class][--depot_.counts[size_class]];
+    cache.bytes += class_bytes;
+    ++count;
+  }
+  return count;
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "vector.h"
+
+namespace capacity_hints_detail {
+
+// Гистограмма с четырьмя корзинами на каждую степень двойки: ёмкость корзины
+// превышает размеры, попавшие в неё, не больше чем на четверть
+inline constexpr size_t kSubBuckets = 4;
+inline constexpr size_t kNumBuckets = kSubBuckets * 63;
+
+inline size_t BucketIndex(size_t size) noexcept {
+  if (size < kSubBuckets) {
+    return size;
+  }
+  const size_t exponent = 63 - __builtin_clzll(size);
+  const size_t sub = (size >> (exponent - 2)) & (kSubBuckets - 1);
+  return kSubBuckets * (exponent - 1) + sub;
+}
+
+// Наибольший размер, попадающий в корзину
+inline size_t BucketCapacity(size_t index) noexcept {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const size_t exponent = index / kSubBuckets + 1;
+  const size_t sub = index % kSubBuckets;
+  return ((kSubBuckets + sub + 1) << (exponent - 2)) - 1;
+}
+
+}  // namespace capacity_hints_detail
+
+#define ADVANCED_VECTOR_HINTS_STRINGIFY_IMPL(x) #x
+#define ADVANCED_VECTOR_HINTS_STRINGIFY(x) ADVANCED_VECTOR_HINTS_STRINGIFY_IMPL(x)
+
+// Статистика итоговых размеров векторов одного места создания. Запись и
+// чтение подсказки не берут блокировок: счётчики корзин атомарны, а
+// подсказка пересчитывается при записи каждого kRefreshPeriod-го размера
+class CapacityHintSite {
+ public:
+  static constexpr size_t kRefreshPeriod = 64;
+
+  explicit CapacityHintSite(std::string key);
+
+  const std::string& Key() const noexcept;
+  size_t Samples() const noexcept;
+  void Record(size_t final_size) noexcept;
+  // Ёмкость, которой хватает для доли CapacityHints::Percentile() векторов.
+  // Пока размеров меньше CapacityHints::kMinSamples, возвращает загруженную
+  // подсказку или 0
+  size_t Hint() const noexcept;
+  void SetLoadedHint(size_t capacity) noexcept;
+
+ private:
+  friend class CapacityHints;
+
+  size_t ComputeHint() const noexcept;
+
+  std::string key_;
+  std::array<std::atomic<size_t>, capacity_hints_detail::kNumBuckets> counts_{};
+  std::atomic<size_t> samples_{0};
+  std::atomic<size_t> learned_hint_{0};
+  std::atomic<size_t> loaded_hint_{0};
+};
+
+// Адаптивное резервирование памяти. Включается вызовом
+// CapacityHints::SetEnabled(true); в выключенном состоянии HintedVector ничего
+// не резервирует и не записывает. Место создания задаётся ключом: строкой,
+// переданной в Site, или макросом ADVANCED_VECTOR_HINT_SITE(), который
+// использует файл и строку вызова. Места живут до конца программы.
+//
+// Dump выводит выученные подсказки строками «ключ<TAB>ёмкость», Load читает их
+// обратно, например при старте программы. Загруженная подсказка действует,
+// пока место не накопит kMinSamples собственных размеров.
+class CapacityHints {
+ public:
+  static constexpr size_t kMinSamples = 16;
+  static constexpr double kDefaultPercentile = 0.9;
+
+  static void SetEnabled(bool enabled) noexcept;
+  static bool IsEnabled() noexcept;
+  // Доля векторов от 0 до 1, которым должно хватить подсказки. Применяется
+  // при следующем пересчёте подсказок
+  static void SetPercentile(double percentile) noexcept;
+  static double Percentile() noexcept;
+
+  // Ключ не должен содержать табуляций и переводов строки
+  static CapacityHintSite& Site(std::string_view key);
+
+  static void Dump(std::ostream& out);
+  // Возвращает число загруженных подсказок. Бросает std::invalid_argument на
+  // строке неверного формата; подсказки из предыдущих строк остаются в силе
+  static size_t Load(std::istream& in);
+
+ private:
+  struct Registry {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<CapacityHintSite>, std::less<>> sites;
+  };
+
+  static Registry& GetRegistry();
+
+  static inline std::atomic<bool> enabled_{false};
+  static inline std::atomic<double> percentile_{kDefaultPercentile};
+};
+
+// Место создания, уникальное для строки исходного кода. Поиск по реестру
+// выполняется один раз, при первом проходе через эту строку
+#define ADVANCED_VECTOR_HINT_SITE()                                    \
+  ([]() -> CapacityHintSite& {                                         \
+    static CapacityHintSite& site = CapacityHints::Site(               \
+        __FILE__ ":" ADVANCED_VECTOR_HINTS_STRINGIFY(__LINE__));       \
+    return site;                                                       \
+  }())
+
+// Vector, который при создании резервирует подсказку места, а при
+// разрушении записывает в него свой итоговый размер. Take отдаёт накопленные
+// элементы обычным Vector, записав размер сразу. Удалять HintedVector через
+// указатель на Vector нельзя.
+template <typename T>
+class HintedVector : public Vector<T> {
+ public:
+  explicit HintedVector(CapacityHintSite& site);
+  HintedVector(const HintedVector&) = delete;
+  HintedVector& operator=(const HintedVector&) = delete;
+  ~HintedVector();
+
+  Vector<T> Take() &&;
+
+ private:
+  CapacityHintSite* site_ = nullptr;
+};
+
+inline CapacityHintSite::CapacityHintSite(std::string key)
+    : key_(std::move(key)) {}
+
+inline const std::string& CapacityHintSite::Key() const noexcept {
+  return key_;
+}
+
+inline size_t CapacityHintSite::Samples() const noexcept {
+  return samples_.load(std::memory_order_relaxed);
+}
+
+inline void CapacityHintSite::Record(size_t final_size) noexcept {
+  counts_[capacity_hints_detail::BucketIndex(final_size)].fetch_add(
+      1, std::memory_order_relaxed);
+  const size_t samples = samples_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (samples == CapacityHints::kMinSamples || samples % kRefreshPeriod == 0) {
+    learned_hint_.store(ComputeHint(), std::memory_order_relaxed);
+  }
+}
+
+inline size_t CapacityHintSite::Hint() const noexcept {
+  return Samples() < CapacityHints::kMinSamples
+             ? loaded_hint_.load(std::memory_order_relaxed)
+             : learned_hint_.load(std::memory_order_relaxed);
+}
+
+inline void CapacityHintSite::SetLoadedHint(size_t capacity) noexcept {
+  loaded_hint_.store(capacity, std::memory_order_relaxed);
+}
+
+inline size_t CapacityHintSite::ComputeHint() const noexcept {
+  using namespace capacity_hints_detail;
+  // Счётчики читаются без общей блокировки, поэтому сумма может немного
+  // расходиться с samples_; считаем по тому, что прочитали
+  std::array<size_t, kNumBuckets> counts;
+  size_t total = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    counts[i] = counts_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  const auto rank = std::max<size_t>(
+      1, static_cast<size_t>(std::ceil(CapacityHints::Percentile() * total)));
+  size_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return BucketCapacity(i);
+    }
+  }
+  return 0;
+}
+
+inline void CapacityHints::SetEnabled(bool enabled) noexcept {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+inline bool CapacityHints::IsEnabled() noexcept {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+inline void CapacityHints::SetPercentile(double percentile) noexcept {
+  assert(percentile >= 0 && percentile <= 1);
+  percentile_.store(percentile, std::memory_order_relaxed);
+}
+
+inline double CapacityHints::Percentile() noexcept {
+  return percentile_.load(std::memory_order_relaxed);
+}
+
+inline CapacityHintSite& CapacityHints::Site(std::string_view key) {
+  assert(key.find_first_of("\t\n") == std::string_view::npos);
+  Registry& registry = GetRegistry();
+  std::lock_guard guard(registry.mutex);
+  auto it = registry.sites.find(key);
+  if (it == registry.sites.end()) {
+    auto site = std::make_unique<CapacityHintSite>(std::string(key));
+    it = registry.sites.emplace(site->Key(), std::move(site)).first;
+  }
+  return *it->second;
+}
+
+inline void CapacityHints::Dump(std::ostream& out) {
+  Registry& registry = GetRegistry();
+  std::lock_guard guard(registry.mutex);
+  for (const auto& [key, site] : registry.sites) {
+    const size_t hint = site->Samples() < kMinSamples ? site->Hint()
+                                                       : site->ComputeHint();
+    if (hint != 0) {
+      out << key << '\t' << hint << '\n';
+    }
+  }
+}
+
+inline size_t CapacityHints::Load(std::istream& in) {
+  size_t loaded = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    const size_t tab = line.rfind('\t');
+    if (tab == std::string::npos || tab == 0 || tab + 1 == line.size() ||
+        line.find_first_not_of("0123456789", tab + 1) != std::string::npos) {
+      throw std::invalid_argument("Malformed capacity hint: " + line);
+    }
+    const auto capacity = std::stoull(line.substr(tab + 1));
+    Site(std::string_view(line).substr(0, tab)).SetLoadedHint(capacity);
+    ++loaded;
+  }
+  return loaded;
+}
+
+inline CapacityHints::Registry& CapacityHints::GetRegistry() {
+  // Реестр не разрушается, чтобы места оставались доступны деструкторам
+  // глобальных объектов
+  static Registry* registry = new Registry;
+  return *registry;
+}
+
+template <typename T>
+HintedVector<T>::HintedVector(CapacityHintSite& site) {
+  if (CapacityHints::IsEnabled()) {
+    site_ = &site;
+    this->Reserve(site.Hint());
+  }
+}
+
+template <typename T>
+HintedVector<T>::~HintedVector() {
+  if (site_ != nullptr) {
+    site_->Record(this->Size());
+  }
+}
+
+template <typename T>
+Vector<T> HintedVector<T>::Take() && {
+  if (site_ != nullptr) {
+    site_->Record(this->Size());
+    site_ = nullptr;
+  }
+  return Vector<T>(std::move(static_cast<Vector<T>&>(*this)));
+}
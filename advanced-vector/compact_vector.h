@@ -0,0 +1,447 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "buffer_cache.h"
+#include "vector.h"
+
+namespace compact_vector_detail {
+
+// Буфер, в начале которого хранятся размер и ёмкость, а за ними элементы.
+// Объект хранит только указатель на первый элемент, пустой буфер — nullptr.
+template <typename T, typename SizeType>
+class Storage {
+  struct Header {
+    SizeType size;
+    SizeType capacity;
+  };
+
+ public:
+  // Элементы начинаются с ближайшей за заголовком позиции, выровненной для T
+  static constexpr size_t kHeaderBytes =
+      (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+  Storage() = default;
+  explicit Storage(size_t capacity);
+
+  Storage(const Storage&) = delete;
+  Storage& operator=(const Storage&) = delete;
+  Storage(Storage&& other) noexcept;
+  Storage& operator=(Storage&& rhs) noexcept;
+
+  ~Storage();
+
+  T* GetAddress() const noexcept;
+  size_t Size() const noexcept;
+  // Размер можно задать только у выделенного буфера
+  void SetSize(size_t size) noexcept;
+  size_t Capacity() const noexcept;
+  void Swap(Storage& other) noexcept;
+
+ private:
+  Header* GetHeader() const noexcept;
+
+  T* data_ = nullptr;
+};
+
+template <typename T, typename SizeType>
+Storage<T, SizeType>::Storage(size_t capacity) {
+  if (capacity == 0) {
+    return;
+  }
+  if (capacity > std::numeric_limits<SizeType>::max()) {
+    throw std::length_error("CompactVector capacity exceeds its size type");
+  }
+  char* block = static_cast<char*>(
+      BufferCache::Allocate(kHeaderBytes + capacity * sizeof(T)));
+  new (block) Header{0, static_cast<SizeType>(capacity)};
+  data_ = reinterpret_cast<T*>(block + kHeaderBytes);
+}
+
+template <typename T, typename SizeType>
+Storage<T, SizeType>::Storage(Storage&& other) noexcept {
+  Swap(other);
+}
+
+template <typename T, typename SizeType>
+Storage<T, SizeType>& Storage<T, SizeType>::operator=(Storage&& rhs) noexcept {
+  if (this != &rhs) {
+    Swap(rhs);
+  }
+  return *this;
+}
+
+template <typename T, typename SizeType>
+Storage<T, SizeType>::~Storage() {
+  if (data_ != nullptr) {
+    BufferCache::Deallocate(GetHeader(),
+                            kHeaderBytes + Capacity() * sizeof(T));
+  }
+}
+
+template <typename T, typename SizeType>
+T* Storage<T, SizeType>::GetAddress() const noexcept {
+  return data_;
+}
+
+template <typename T, typename SizeType>
+size_t Storage<T, SizeType>::Size() const noexcept {
+  return data_ == nullptr ? 0 : GetHeader()->size;
+}
+
+template <typename T, typename SizeType>
+void Storage<T, SizeType>::SetSize(size_t size) noexcept {
+  assert(size <= Capacity());
+  if (data_ != nullptr) {
+    GetHeader()->size = static_cast<SizeType>(size);
+  }
+}
+
+template <typename T, typename SizeType>
+size_t Storage<T, SizeType>::Capacity() const noexcept {
+  return data_ == nullptr ? 0 : GetHeader()->capacity;
+}
+
+template <typename T, typename SizeType>
+void Storage<T, SizeType>::Swap(Storage& other) noexcept {
+  std::swap(data_, other.data_);
+}
+
+template <typename T, typename SizeType>
+typename Storage<T, SizeType>::Header* Storage<T, SizeType>::GetHeader()
+    const noexcept {
+  return std::launder(reinterpret_cast<Header*>(
+      reinterpret_cast<char*>(data_) - kHeaderBytes));
+}
+
+}  // namespace compact_vector_detail
+
+// Вектор размером в один указатель: размер и ёмкость хранятся в начале
+// выделенного блока, а пустой вектор не выделяет памяти. Подходит для
+// вложенных контейнеров вроде списков смежности, где большинство внутренних
+// векторов пусты. SizeType ограничивает размер и ёмкость; uint32_t уменьшает
+// заголовок блока до 8 байт. Интерфейс и гарантии безопасности исключений те
+// же, что у Vector, но размер вектора читается из памяти блока.
+template <typename T, typename SizeType = size_t>
+class CompactVector {
+  static_assert(std::is_unsigned_v<SizeType>);
+  static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                "over-aligned types are not supported");
+
+ public:
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  // Байты, которые заголовок занимает в каждом выделенном блоке
+  static constexpr size_t kHeaderBytes =
+      compact_vector_detail::Storage<T, SizeType>::kHeaderBytes;
+
+  CompactVector() = default;
+  explicit CompactVector(size_t size);
+  CompactVector(const CompactVector& other);
+  CompactVector(CompactVector&& other) noexcept;
+  CompactVector& operator=(const CompactVector& rhs);
+  CompactVector& operator=(CompactVector&& rhs) noexcept;
+  ~CompactVector();
+
+  size_t Size() const noexcept;
+  size_t Capacity() const noexcept;
+  T& operator[](size_t index) noexcept;
+  const T& operator[](size_t index) const noexcept;
+  void Reserve(size_t new_capacity);
+  void Resize(size_t new_size);
+  iterator Insert(const_iterator pos, const T& value);
+  iterator Insert(const_iterator pos, T&& value);
+  template <typename... Args>
+  iterator Emplace(const_iterator pos, Args&&... args);
+  iterator Erase(const_iterator pos);
+  void PushBack(const T& value);
+  void PushBack(T&& value);
+  template <typename... Args>
+  T& EmplaceBack(Args&&... args);
+  void PopBack();
+  void Clear() noexcept;
+  T& Back() noexcept;
+  void Swap(CompactVector& other) noexcept;
+
+  iterator begin() noexcept;
+  iterator end() noexcept;
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend() const noexcept;
+
+ private:
+  using Storage = compact_vector_detail::Storage<T, SizeType>;
+
+  // Ёмкость после роста заполненного вектора размера size
+  static size_t GrownCapacity(size_t size);
+
+  Storage data_;
+};
+
+template <typename T, typename SizeType>
+CompactVector<T, SizeType>::CompactVector(size_t size) : data_{size} {
+  std::uninitialized_value_construct_n(data_.GetAddress(), size);
+  data_.SetSize(size);
+}
+
+template <typename T, typename SizeType>
+CompactVector<T, SizeType>::CompactVector(const CompactVector& other)
+    : data_{other.Size()} {
+  std::uninitialized_copy(other.begin(), other.end(), data_.GetAddress());
+  data_.SetSize(other.Size());
+}
+
+template <typename T, typename SizeType>
+CompactVector<T, SizeType>::CompactVector(CompactVector&& other) noexcept
+    : data_{std::move(other.data_)} {}
+
+template <typename T, typename SizeType>
+CompactVector<T, SizeType>& CompactVector<T, SizeType>::operator=(
+    const CompactVector& rhs) {
+  if (this == &rhs) {
+    return *this;
+  }
+  if (rhs.Size() > Capacity()) {
+    CompactVector rhs_copy(rhs);
+    Swap(rhs_copy);
+  } else {
+    const size_t size = Size();
+    if (rhs.Size() < size) {
+      std::copy(rhs.cbegin(), rhs.cend(), begin());
+      std::destroy_n(begin() + rhs.Size(), size - rhs.Size());
+    } else {
+      std::copy(rhs.cbegin(), rhs.cbegin() + size, begin());
+      std::uninitialized_copy_n(rhs.cbegin() + size, rhs.Size() - size, end());
+    }
+    data_.SetSize(rhs.Size());
+  }
+  return *this;
+}
+
+template <typename T, typename SizeType>
+CompactVector<T, SizeType>& CompactVector<T, SizeType>::operator=(
+    CompactVector&& rhs) noexcept {
+  if (this != &rhs) {
+    Swap(rhs);
+  }
+  return *this;
+}
+
+template <typename T, typename SizeType>
+CompactVector<T, SizeType>::~CompactVector() {
+  std::destroy(begin(), end());
+}
+
+template <typename T, typename SizeType>
+size_t CompactVector<T, SizeType>::Size() const noexcept {
+  return data_.Size();
+}
+
+template <typename T, typename SizeType>
+size_t CompactVector<T, SizeType>::Capacity() const noexcept {
+  return data_.Capacity();
+}
+
+template <typename T, typename SizeType>
+const T& CompactVector<T, SizeType>::operator[](size_t index) const noexcept {
+  return const_cast<CompactVector&>(*this)[index];
+}
+
+template <typename T, typename SizeType>
+T& CompactVector<T, SizeType>::operator[](size_t index) noexcept {
+  assert(index < Size());
+  return data_.GetAddress()[index];
+}
+
+template <typename T, typename SizeType>
+void CompactVector<T, SizeType>::Reserve(size_t new_capacity) {
+  if (new_capacity <= Capacity()) {
+    return;
+  }
+  Storage new_data{new_capacity};
+  vector_detail::UninitMoveOrCopy(begin(), end(), new_data.GetAddress());
+  std::destroy(begin(), end());
+  new_data.SetSize(Size());
+  data_.Swap(new_data);
+}
+
+template <typename T, typename SizeType>
+void CompactVector<T, SizeType>::Resize(size_t new_size) {
+  const size_t size = Size();
+  if (new_size > size) {
+    if (new_size > Capacity()) {
+      Reserve(std::max(new_size, size * 2));
+    }
+    std::uninitialized_value_construct_n(end(), new_size - size);
+  } else {
+    std::destroy_n(begin() + new_size, size - new_size);
+  }
+  data_.SetSize(new_size);
+}
+
+template <typename T, typename SizeType>
+typename CompactVector<T, SizeType>::iterator CompactVector<T, SizeType>::Insert(
+    const_iterator pos, const T& value) {
+  return Emplace(pos, value);
+}
+
+template <typename T, typename SizeType>
+typename CompactVector<T, SizeType>::iterator CompactVector<T, SizeType>::Insert(
+    const_iterator pos, T&& value) {
+  return Emplace(pos, std::move(value));
+}
+
+template <typename T, typename SizeType>
+template <typename... Args>
+typename CompactVector<T, SizeType>::iterator
+CompactVector<T, SizeType>::Emplace(const_iterator pos, Args&&... args) {
+  assert(pos >= begin() && pos <= end());
+  auto pos_non_const = const_cast<iterator>(pos);
+  const size_t size = Size();
+  if (size == Capacity()) {
+    Storage new_data{GrownCapacity(size)};
+    auto new_begin = new_data.GetAddress();
+    auto new_pos = new (new_begin + (pos - begin())) T(std::forward<Args>(args)...);
+    vector_detail::TryUninitMoveOrCopy(begin(), pos_non_const, new_begin,
+                                       new_pos, new_pos + 1);
+    vector_detail::TryUninitMoveOrCopy(pos_non_const, end(), new_pos + 1,
+                                       new_begin, new_pos + 1);
+    std::destroy(begin(), end());
+    new_data.SetSize(size + 1);
+    data_.Swap(new_data);
+    return new_pos;
+  }
+  if (pos != end()) {
+    T element(std::forward<Args>(args)...);
+    // Как и в Vector, сдвиг внутри буфера всегда перемещает
+    std::uninitialized_move(end() - 1, end(), end());
+    std::move_backward(pos_non_const, end() - 1, end());
+    *pos_non_const = std::move(element);
+  } else {
+    new (end()) T(std::forward<Args>(args)...);
+  }
+  data_.SetSize(size + 1);
+  return pos_non_const;
+}
+
+template <typename T, typename SizeType>
+typename CompactVector<T, SizeType>::iterator CompactVector<T, SizeType>::Erase(
+    const_iterator pos) {
+  assert(pos >= begin() && pos < end());
+  auto pos_non_const = const_cast<iterator>(pos);
+  std::move(pos_non_const + 1, end(), pos_non_const);
+  std::destroy_at(end() - 1);
+  data_.SetSize(Size() - 1);
+  return pos_non_const;
+}
+
+template <typename T, typename SizeType>
+void CompactVector<T, SizeType>::PushBack(const T& value) {
+  EmplaceBack(value);
+}
+
+template <typename T, typename SizeType>
+void CompactVector<T, SizeType>::PushBack(T&& value) {
+  EmplaceBack(std::move(value));
+}
+
+template <typename T, typename SizeType>
+template <typename... Args>
+T& CompactVector<T, SizeType>::EmplaceBack(Args&&... args) {
+  const size_t size = Size();
+  if (size == Capacity()) {
+    Storage new_data{GrownCapacity(size)};
+    new (new_data.GetAddress() + size) T(std::forward<Args>(args)...);
+    vector_detail::TryUninitMoveOrCopy(begin(), end(), new_data.GetAddress(),
+                                       new_data.GetAddress() + size,
+                                       new_data.GetAddress() + size + 1);
+    std::destroy(begin(), end());
+    new_data.SetSize(size + 1);
+    data_.Swap(new_data);
+  } else {
+    new (end()) T(std::forward<Args>(args)...);
+    data_.SetSize(size + 1);
+  }
+  return Back();
+}
+
+template <typename T, typename SizeType>
+void CompactVector<T, SizeType>::PopBack() {
+  assert(Size() != 0);
+  data_.SetSize(Size() - 1);
+  std::destroy_at(end());
+}
+
+template <typename T, typename SizeType>
+void CompactVector<T, SizeType>::Clear() noexcept {
+  std::destroy(begin(), end());
+  data_.SetSize(0);
+}
+
+template <typename T, typename SizeType>
+T& CompactVector<T, SizeType>::Back() noexcept {
+  return *(end() - 1);
+}
+
+template <typename T, typename SizeType>
+void CompactVector<T, SizeType>::Swap(CompactVector& other) noexcept {
+  data_.Swap(other.data_);
+}
+
+template <typename T, typename SizeType>
+typename CompactVector<T, SizeType>::iterator
+CompactVector<T, SizeType>::begin() noexcept {
+  return data_.GetAddress();
+}
+
+template <typename T, typename SizeType>
+typename CompactVector<T, SizeType>::iterator
+CompactVector<T, SizeType>::end() noexcept {
+  return data_.GetAddress() + Size();
+}
+
+template <typename T, typename SizeType>
+typename CompactVector<T, SizeType>::const_iterator
+CompactVector<T, SizeType>::begin() const noexcept {
+  return data_.GetAddress();
+}
+
+template <typename T, typename SizeType>
+typename CompactVector<T, SizeType>::const_iterator
+CompactVector<T, SizeType>::end() const noexcept {
+  return data_.GetAddress() + Size();
+}
+
+template <typename T, typename SizeType>
+typename CompactVector<T, SizeType>::const_iterator
+CompactVector<T, SizeType>::cbegin() const noexcept {
+  return begin();
+}
+
+template <typename T, typename SizeType>
+typename CompactVector<T, SizeType>::const_iterator
+CompactVector<T, SizeType>::cend() const noexcept {
+  return end();
+}
+
+template <typename T, typename SizeType>
+size_t CompactVector<T, SizeType>::GrownCapacity(size_t size) {
+  constexpr size_t kMaxCapacity = std::numeric_limits<SizeType>::max();
+  if (size == kMaxCapacity) {
+    throw std::length_error("CompactVector size exceeds its size type");
+  }
+  if (size == 0) {
+    return 1;
+  }
+  return size > kMaxCapacity / 2 ? kMaxCapacity : size * 2;
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace deferred_destruction_detail {
+
+// Буфер с живыми элементами и функция, знающая их тип
+struct Job {
+  void (*reclaim)(const Job& job) = nullptr;
+  void* data = nullptr;
+  size_t size = 0;
+  size_t capacity = 0;
+  // Функция освобождения RawMemory<T>::Deleter, приведённая к общему типу
+  void (*deleter)() = nullptr;
+};
+
+struct Reclaimer {
+  ~Reclaimer();
+
+  std::mutex mutex;
+  std::condition_variable has_work;
+  std::condition_variable drained;
+  std::deque<Job> jobs;
+  std::thread thread;
+  bool busy = false;
+  bool stop = false;
+};
+
+}  // namespace deferred_destruction_detail
+
+// Отложенное разрушение больших векторов. Деструктор Vector обращается к
+// DeferredDestruction только при компиляции с макросом
+// ADVANCED_VECTOR_DEFERRED_DESTRUCTION, который должен быть одинаковым во всех
+// единицах трансляции. После вызова
+// DeferredDestruction::SetEnabled(true) деструктор Vector, буфер которого
+// занимает не меньше Threshold() байт, не разрушает элементы сам, а передаёт
+// буфер фоновому потоку, который разрушает элементы и освобождает память.
+// Поток запускается при первой передаче. Деструкторы элементов выполняются в
+// другом потоке, поэтому не должны зависеть от потока, в котором жил вектор.
+//
+// Drain дожидается, пока будут освобождены все переданные буферы; его стоит
+// вызывать при завершении работы и в тестах. При завершении программы очередь
+// освобождается автоматически, а векторы, разрушаемые после этого,
+// разрушаются синхронно.
+class DeferredDestruction {
+ public:
+  static constexpr size_t kDefaultThreshold = size_t{1} << 20;
+
+  static void SetEnabled(bool enabled) noexcept;
+  static bool IsEnabled() noexcept;
+  static void SetThreshold(size_t bytes) noexcept;
+  static size_t Threshold() noexcept;
+  // Стоит ли откладывать освобождение буфера такого размера
+  static bool ShouldDefer(size_t bytes) noexcept;
+
+  // Передаёт буфер с size живыми элементами фоновому потоку. Возвращает false,
+  // если передача невозможна; тогда буфер остаётся у вызывающего
+  template <typename T>
+  static bool Defer(T* data, size_t size, size_t capacity,
+                    void (*deleter)(T*, size_t)) noexcept;
+  // Ожидает освобождения всех переданных буферов
+  static void Drain();
+
+ private:
+  using Job = deferred_destruction_detail::Job;
+  using Reclaimer = deferred_destruction_detail::Reclaimer;
+  friend Reclaimer;
+
+  static bool Enqueue(const Job& job) noexcept;
+  static Reclaimer& GetReclaimer();
+  static void Run(Reclaimer& reclaimer);
+
+  static inline std::atomic<bool> enabled_{false};
+  static inline std::atomic<size_t> threshold_{kDefaultThreshold};
+  // Тривиально разрушаемый флаг, по которому видно, что поток уже остановлен
+  static inline std::atomic<bool> reclaimer_alive_{true};
+  // Векторы, разрушаемые самим фоновым потоком, разрушаются сразу
+  static inline thread_local bool in_reclaimer_ = false;
+};
+
+inline void DeferredDestruction::SetEnabled(bool enabled) noexcept {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+inline bool DeferredDestruction::IsEnabled() noexcept {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+inline void DeferredDestruction::SetThreshold(size_t bytes) noexcept {
+  threshold_.store(bytes, std::memory_order_relaxed);
+}
+
+inline size_t DeferredDestruction::Threshold() noexcept {
+  return threshold_.load(std::memory_order_relaxed);
+}
+
+inline bool DeferredDestruction::ShouldDefer(size_t bytes) noexcept {
+  return IsEnabled() && bytes != 0 && bytes >= Threshold();
+}
+
+template <typename T>
+bool DeferredDestruction::Defer(T* data, size_t size, size_t capacity,
+                                void (*deleter)(T*, size_t)) noexcept {
+  Job job;
+  job.reclaim = [](const Job& deferred) {
+    T* buffer = static_cast<T*>(deferred.data);
+    std::destroy_n(buffer, deferred.size);
+    reinterpret_cast<void (*)(T*, size_t)>(deferred.deleter)(buffer,
+                                                             deferred.capacity);
+  };
+  job.data = data;
+  job.size = size;
+  job.capacity = capacity;
+  job.deleter = reinterpret_cast<void (*)()>(deleter);
+  return Enqueue(job);
+}
+
+inline void DeferredDestruction::Drain() {
+  if (!reclaimer_alive_) {
+    return;
+  }
+  Reclaimer& reclaimer = GetReclaimer();
+  std::unique_lock lock(reclaimer.mutex);
+  reclaimer.drained.wait(lock, [&reclaimer] {
+    return reclaimer.jobs.empty() && !reclaimer.busy;
+  });
+}
+
+inline bool DeferredDestruction::Enqueue(const Job& job) noexcept {
+  if (in_reclaimer_ || !reclaimer_alive_) {
+    return false;
+  }
+  try {
+    Reclaimer& reclaimer = GetReclaimer();
+    std::lock_guard guard(reclaimer.mutex);
+    if (!reclaimer.thread.joinable()) {
+      reclaimer.thread = std::thread(&DeferredDestruction::Run,
+                                     std::ref(reclaimer));
+    }
+    reclaimer.jobs.push_back(job);
+  } catch (...) {
+    return false;
+  }
+  GetReclaimer().has_work.notify_one();
+  return true;
+}
+
+inline DeferredDestruction::Reclaimer& DeferredDestruction::GetReclaimer() {
+  static Reclaimer reclaimer;
+  return reclaimer;
+}
+
+inline void DeferredDestruction::Run(Reclaimer& reclaimer) {
+  in_reclaimer_ = true;
+  std::unique_lock lock(reclaimer.mutex);
+  while (true) {
+    reclaimer.has_work.wait(lock, [&reclaimer] {
+      return reclaimer.stop || !reclaimer.jobs.empty();
+    });
+    if (reclaimer.jobs.empty()) {
+      return;
+    }
+    const Job job = reclaimer.jobs.front();
+    reclaimer.jobs.pop_front();
+    reclaimer.busy = true;
+    lock.unlock();
+    job.reclaim(job);
+    lock.lock();
+    reclaimer.busy = false;
+    if (reclaimer.jobs.empty()) {
+      reclaimer.drained.notify_all();
+    }
+  }
+}
+
+inline deferred_destruction_detail::Reclaimer::~Reclaimer() {
+  {
+    std::lock_guard guard(mutex);
+    stop = true;
+    // Новые буферы после этого разрушаются синхронно
+    DeferredDestruction::reclaimer_alive_.store(false);
+  }
+  has_work.notify_one();
+  // Поток завершается, только разобрав всю очередь
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
@@ -0,0 +1,177 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "flat_tree.h"
+
+// Итератор FlatMap. Элементы хранятся как std::pair<Key, Value>, а
+// разыменование даёт пару ссылок std::pair<const Key&, Value&>, поэтому
+// значение изменять можно, а ключ — нет. Ссылки на элемент живут, пока жив
+// сам элемент, так что `for (auto [key, value] : map)` изменяет значения
+// на месте.
+template <typename Key, typename Value, bool Const>
+class FlatMapIterator {
+  using Stored =
+      std::conditional_t<Const, const std::pair<Key, Value>, std::pair<Key, Value>>;
+
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::pair<Key, Value>;
+  using difference_type = std::ptrdiff_t;
+  using reference =
+      std::pair<const Key&, std::conditional_t<Const, const Value&, Value&>>;
+
+  // Результат operator->: хранит пару ссылок, на которую указывает
+  class pointer {
+   public:
+    explicit pointer(reference ref) noexcept : ref_(ref) {}
+    const reference* operator->() const noexcept { return &ref_; }
+
+   private:
+    reference ref_;
+  };
+
+  FlatMapIterator() = default;
+  explicit FlatMapIterator(Stored* pos) noexcept : pos_(pos) {}
+  template <bool C = Const, typename = std::enable_if_t<C>>
+  FlatMapIterator(FlatMapIterator<Key, Value, false> other) noexcept
+      : pos_(other.Base()) {}
+
+  Stored* Base() const noexcept { return pos_; }
+
+  reference operator*() const noexcept { return {pos_->first, pos_->second}; }
+  pointer operator->() const noexcept { return pointer(**this); }
+  reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+  FlatMapIterator& operator++() noexcept {
+    ++pos_;
+    return *this;
+  }
+  FlatMapIterator operator++(int) noexcept { return FlatMapIterator(pos_++); }
+  FlatMapIterator& operator--() noexcept {
+    --pos_;
+    return *this;
+  }
+  FlatMapIterator operator--(int) noexcept { return FlatMapIterator(pos_--); }
+  FlatMapIterator& operator+=(difference_type n) noexcept {
+    pos_ += n;
+    return *this;
+  }
+  FlatMapIterator& operator-=(difference_type n) noexcept {
+    pos_ -= n;
+    return *this;
+  }
+
+  friend FlatMapIterator operator+(FlatMapIterator it, difference_type n) noexcept {
+    return it += n;
+  }
+  friend FlatMapIterator operator+(difference_type n, FlatMapIterator it) noexcept {
+    return it += n;
+  }
+  friend FlatMapIterator operator-(FlatMapIterator it, difference_type n) noexcept {
+    return it -= n;
+  }
+  friend difference_type operator-(FlatMapIterator lhs, FlatMapIterator rhs) noexcept {
+    return lhs.pos_ - rhs.pos_;
+  }
+  friend bool operator==(FlatMapIterator lhs, FlatMapIterator rhs) noexcept {
+    return lhs.pos_ == rhs.pos_;
+  }
+  friend bool operator!=(FlatMapIterator lhs, FlatMapIterator rhs) noexcept {
+    return lhs.pos_ != rhs.pos_;
+  }
+  friend bool operator<(FlatMapIterator lhs, FlatMapIterator rhs) noexcept {
+    return lhs.pos_ < rhs.pos_;
+  }
+  friend bool operator>(FlatMapIterator lhs, FlatMapIterator rhs) noexcept {
+    return lhs.pos_ > rhs.pos_;
+  }
+  friend bool operator<=(FlatMapIterator lhs, FlatMapIterator rhs) noexcept {
+    return lhs.pos_ <= rhs.pos_;
+  }
+  friend bool operator>=(FlatMapIterator lhs, FlatMapIterator rhs) noexcept {
+    return lhs.pos_ >= rhs.pos_;
+  }
+
+ private:
+  Stored* pos_ = nullptr;
+};
+
+namespace flat_tree_detail {
+
+template <typename Key, typename Value>
+struct MapIterators {
+  using iterator = FlatMapIterator<Key, Value, false>;
+  using const_iterator = FlatMapIterator<Key, Value, true>;
+
+  static const std::pair<Key, Value>* Base(const_iterator pos) noexcept {
+    return pos.Base();
+  }
+};
+
+struct SelectFirst {
+  template <typename Pair>
+  using Iterators =
+      MapIterators<typename Pair::first_type, typename Pair::second_type>;
+
+  template <typename Pair>
+  const typename Pair::first_type& operator()(const Pair& value) const noexcept {
+    return value.first;
+  }
+};
+
+}  // namespace flat_tree_detail
+
+// Упорядоченный ассоциативный массив в непрерывной памяти. Элементы хранятся
+// как std::pair<Key, Value>, итераторы дают доступ к ключу только для чтения.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMap : public FlatTree<Key, std::pair<Key, Value>,
+                                flat_tree_detail::SelectFirst, Compare> {
+  using Base = FlatTree<Key, std::pair<Key, Value>,
+                        flat_tree_detail::SelectFirst, Compare>;
+
+ public:
+  using Base::Base;
+
+  Value& operator[](const Key& key);
+  Value& operator[](Key&& key);
+  // Выбрасывает std::out_of_range, если ключа нет
+  Value& At(const Key& key);
+  const Value& At(const Key& key) const;
+};
+
+template <typename Key, typename Value, typename Compare>
+Value& FlatMap<Key, Value, Compare>::operator[](const Key& key) {
+  auto pos = this->LowerBoundImpl(key);
+  if (pos == this->data_.end() || this->compare_(key, pos->first)) {
+    pos = this->data_.Emplace(pos, key, Value());
+  }
+  return this->MakeIterator(pos)->second;
+}
+
+template <typename Key, typename Value, typename Compare>
+Value& FlatMap<Key, Value, Compare>::operator[](Key&& key) {
+  auto pos = this->LowerBoundImpl(key);
+  if (pos == this->data_.end() || this->compare_(key, pos->first)) {
+    pos = this->data_.Emplace(pos, std::move(key), Value());
+  }
+  return this->MakeIterator(pos)->second;
+}
+
+template <typename Key, typename Value, typename Compare>
+Value& FlatMap<Key, Value, Compare>::At(const Key& key) {
+  return const_cast<Value&>(static_cast<const FlatMap&>(*this).At(key));
+}
+
+template <typename Key, typename Value, typename Compare>
+const Value& FlatMap<Key, Value, Compare>::At(const Key& key) const {
+  auto pos = this->FindImpl(key);
+  if (pos == this->data_.end()) {
+    throw std::out_of_range("FlatMap::At: key not found");
+  }
+  return pos->second;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <functional>
+
+#include "flat_tree.h"
+
+namespace flat_tree_detail {
+
+struct Identity {
+  template <typename Value>
+  using Iterators = ConstPointerIterators<Value>;
+
+  template <typename T>
+  const T& operator()(const T& value) const noexcept {
+    return value;
+  }
+};
+
+}  // namespace flat_tree_detail
+
+// Упорядоченное множество в непрерывной памяти
+template <typename Key, typename Compare = std::less<Key>>
+class FlatSet
+    : public FlatTree<Key, Key, flat_tree_detail::Identity, Compare> {
+  using Base = FlatTree<Key, Key, flat_tree_detail::Identity, Compare>;
+
+ public:
+  using Base::Base;
+};
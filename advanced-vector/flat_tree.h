@@ -0,0 +1,349 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+namespace flat_tree_detail {
+
+// Итераторы множества — указатели на константные элементы, так как изменение
+// элемента нарушило бы порядок
+template <typename Value>
+struct ConstPointerIterators {
+  using iterator = const Value*;
+  using const_iterator = const Value*;
+
+  static const Value* Base(const_iterator pos) noexcept { return pos; }
+};
+
+}  // namespace flat_tree_detail
+
+// Общая основа FlatSet и FlatMap: элементы хранятся в Vector, отсортированными
+// по ключу, поиск выполняется бинарным поиском. KeyOfValue извлекает ключ из
+// элемента и задаёт шаблоном Iterators<Value> типы итераторов: они строятся
+// из указателя на элемент и не дают изменить ключ.
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+class FlatTree {
+  // Поиск по ключу другого типа доступен только для прозрачного компаратора.
+  // Компаратор передаётся параметром C, чтобы проверка была SFINAE-контекстом
+  template <typename K, typename C>
+  using EnableTransparent =
+      std::enable_if_t<!std::is_same_v<K, Key>,
+                       std::void_t<typename C::is_transparent>>;
+  using Iterators = typename KeyOfValue::template Iterators<Value>;
+
+ public:
+  using iterator = typename Iterators::iterator;
+  using const_iterator = typename Iterators::const_iterator;
+
+  FlatTree() = default;
+  explicit FlatTree(const Compare& compare);
+
+  size_t Size() const noexcept;
+  bool Empty() const noexcept;
+  size_t Capacity() const noexcept;
+  void Reserve(size_t new_capacity);
+  void Clear() noexcept;
+
+  std::pair<iterator, bool> Insert(const Value& value);
+  std::pair<iterator, bool> Insert(Value&& value);
+  template <typename... Args>
+  std::pair<iterator, bool> Emplace(Args&&... args);
+  // Добавляет элементы в конец, сортирует их и сливает с имеющимися за
+  // O(n + m log m) вместо m вставок со сдвигом хвоста. При равных ключах
+  // сохраняется уже имеющийся элемент либо первый из диапазона
+  template <typename InputIt>
+  void InsertRange(InputIt first, InputIt last);
+  iterator Erase(const_iterator pos);
+  size_t Erase(const Key& key);
+
+  iterator Find(const Key& key);
+  const_iterator Find(const Key& key) const;
+  template <typename K, typename C = Compare,
+            typename = EnableTransparent<K, C>>
+  iterator Find(const K& key);
+  template <typename K, typename C = Compare,
+            typename = EnableTransparent<K, C>>
+  const_iterator Find(const K& key) const;
+  bool Contains(const Key& key) const;
+  template <typename K, typename C = Compare,
+            typename = EnableTransparent<K, C>>
+  bool Contains(const K& key) const;
+  iterator LowerBound(const Key& key);
+  const_iterator LowerBound(const Key& key) const;
+  template <typename K, typename C = Compare,
+            typename = EnableTransparent<K, C>>
+  iterator LowerBound(const K& key);
+  template <typename K, typename C = Compare,
+            typename = EnableTransparent<K, C>>
+  const_iterator LowerBound(const K& key) const;
+
+  iterator begin() noexcept;
+  iterator end() noexcept;
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend() const noexcept;
+
+ protected:
+  template <typename K>
+  const Value* LowerBoundImpl(const K& key) const;
+  template <typename K>
+  const Value* FindImpl(const K& key) const;
+  bool KeyLess(const Value& lhs, const Value& rhs) const;
+  iterator MakeIterator(const Value* pos) noexcept;
+
+  Vector<Value> data_;
+  Compare compare_;
+};
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+FlatTree<Key, Value, KeyOfValue, Compare>::FlatTree(const Compare& compare)
+    : compare_(compare) {}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+size_t FlatTree<Key, Value, KeyOfValue, Compare>::Size() const noexcept {
+  return data_.Size();
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+bool FlatTree<Key, Value, KeyOfValue, Compare>::Empty() const noexcept {
+  return data_.Size() == 0;
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+size_t FlatTree<Key, Value, KeyOfValue, Compare>::Capacity() const noexcept {
+  return data_.Capacity();
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+void FlatTree<Key, Value, KeyOfValue, Compare>::Reserve(size_t new_capacity) {
+  data_.Reserve(new_capacity);
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+void FlatTree<Key, Value, KeyOfValue, Compare>::Clear() noexcept {
+  data_.Clear();
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+std::pair<typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator, bool>
+FlatTree<Key, Value, KeyOfValue, Compare>::Insert(const Value& value) {
+  auto pos = LowerBoundImpl(KeyOfValue{}(value));
+  if (pos != data_.end() && !compare_(KeyOfValue{}(value), KeyOfValue{}(*pos))) {
+    return {MakeIterator(pos), false};
+  }
+  return {MakeIterator(data_.Insert(pos, value)), true};
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+std::pair<typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator, bool>
+FlatTree<Key, Value, KeyOfValue, Compare>::Insert(Value&& value) {
+  auto pos = LowerBoundImpl(KeyOfValue{}(value));
+  if (pos != data_.end() && !compare_(KeyOfValue{}(value), KeyOfValue{}(*pos))) {
+    return {MakeIterator(pos), false};
+  }
+  return {MakeIterator(data_.Insert(pos, std::move(value))), true};
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+template <typename... Args>
+std::pair<typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator, bool>
+FlatTree<Key, Value, KeyOfValue, Compare>::Emplace(Args&&... args) {
+  // Ключ известен только после создания элемента
+  return Insert(Value(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+template <typename InputIt>
+void FlatTree<Key, Value, KeyOfValue, Compare>::InsertRange(InputIt first,
+                                                            InputIt last) {
+  if constexpr (std::is_base_of_v<
+                    std::forward_iterator_tag,
+                    typename std::iterator_traits<InputIt>::iterator_category>) {
+    data_.Reserve(data_.Size() + std::distance(first, last));
+  }
+  const size_t old_size = data_.Size();
+  try {
+    for (; first != last; ++first) {
+      data_.EmplaceBack(*first);
+    }
+  } catch (...) {
+    while (data_.Size() != old_size) {
+      data_.PopBack();
+    }
+    throw;
+  }
+  auto less = [this](const Value& lhs, const Value& rhs) {
+    return KeyLess(lhs, rhs);
+  };
+  try {
+    auto middle = data_.begin() + old_size;
+    std::stable_sort(middle, data_.end(), less);
+    std::inplace_merge(data_.begin(), middle, data_.end(), less);
+  } catch (...) {
+    // После частичного слияния порядок элементов не восстановить,
+    // поэтому инвариант сохраняется очисткой контейнера
+    data_.Clear();
+    throw;
+  }
+  // Слияние устойчиво, поэтому первым в группе равных ключей оказывается
+  // элемент, который был в контейнере раньше
+  auto new_end = std::unique(data_.begin(), data_.end(),
+                             [&less](const Value& lhs, const Value& rhs) {
+                               return !less(lhs, rhs);
+                             });
+  while (data_.end() != new_end) {
+    data_.PopBack();
+  }
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::Erase(const_iterator pos) {
+  return MakeIterator(data_.Erase(Iterators::Base(pos)));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+size_t FlatTree<Key, Value, KeyOfValue, Compare>::Erase(const Key& key) {
+  auto pos = FindImpl(key);
+  if (pos == data_.end()) {
+    return 0;
+  }
+  data_.Erase(pos);
+  return 1;
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::Find(const Key& key) {
+  return MakeIterator(FindImpl(key));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::const_iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::Find(const Key& key) const {
+  return const_iterator(FindImpl(key));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+template <typename K, typename C, typename>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::Find(const K& key) {
+  return MakeIterator(FindImpl(key));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+template <typename K, typename C, typename>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::const_iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::Find(const K& key) const {
+  return const_iterator(FindImpl(key));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+bool FlatTree<Key, Value, KeyOfValue, Compare>::Contains(const Key& key) const {
+  return FindImpl(key) != data_.end();
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+template <typename K, typename C, typename>
+bool FlatTree<Key, Value, KeyOfValue, Compare>::Contains(const K& key) const {
+  return FindImpl(key) != data_.end();
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::LowerBound(const Key& key) {
+  return MakeIterator(LowerBoundImpl(key));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::const_iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::LowerBound(const Key& key) const {
+  return const_iterator(LowerBoundImpl(key));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+template <typename K, typename C, typename>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::LowerBound(const K& key) {
+  return MakeIterator(LowerBoundImpl(key));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+template <typename K, typename C, typename>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::const_iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::LowerBound(const K& key) const {
+  return const_iterator(LowerBoundImpl(key));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::begin() noexcept {
+  return MakeIterator(data_.begin());
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::end() noexcept {
+  return MakeIterator(data_.end());
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::const_iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::begin() const noexcept {
+  return const_iterator(data_.begin());
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::const_iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::end() const noexcept {
+  return const_iterator(data_.end());
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::const_iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::cbegin() const noexcept {
+  return begin();
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::const_iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::cend() const noexcept {
+  return end();
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+template <typename K>
+const Value* FlatTree<Key, Value, KeyOfValue, Compare>::LowerBoundImpl(const K& key) const {
+  return std::lower_bound(data_.begin(), data_.end(), key,
+                          [this](const Value& value, const K& key) {
+                            return compare_(KeyOfValue{}(value), key);
+                          });
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+template <typename K>
+const Value* FlatTree<Key, Value, KeyOfValue, Compare>::FindImpl(const K& key) const {
+  auto pos = LowerBoundImpl(key);
+  if (pos != data_.end() && !compare_(key, KeyOfValue{}(*pos))) {
+    return pos;
+  }
+  return data_.end();
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+bool FlatTree<Key, Value, KeyOfValue, Compare>::KeyLess(
+    const Value& lhs, const Value& rhs) const {
+  return compare_(KeyOfValue{}(lhs), KeyOfValue{}(rhs));
+}
+
+template <typename Key, typename Value, typename KeyOfValue, typename Compare>
+typename FlatTree<Key, Value, KeyOfValue, Compare>::iterator
+FlatTree<Key, Value, KeyOfValue, Compare>::MakeIterator(
+    const Value* pos) noexcept {
+  return iterator(const_cast<Value*>(pos));
+}
@@ -0,0 +1,318 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Буфер с разрывом (gap buffer). Элементы хранятся в двух частях одного блока
+// памяти: [0, gap_begin_) и [gap_end_, capacity). Вставка и удаление в позиции
+// курсора (начало разрыва) выполняются за амортизированное O(1), перемещение
+// курсора стоит O(расстояние).
+template <typename T>
+class GapVector {
+  template <bool IsConst>
+  class BasicIterator;
+
+ public:
+  using iterator = BasicIterator<false>;
+  using const_iterator = BasicIterator<true>;
+
+  GapVector() = default;
+  GapVector(const GapVector& other);
+  GapVector(GapVector&& other) noexcept;
+  GapVector& operator=(const GapVector& rhs);
+  GapVector& operator=(GapVector&& rhs) noexcept;
+  ~GapVector();
+
+  size_t Size() const noexcept;
+  size_t Capacity() const noexcept;
+  size_t Cursor() const noexcept;
+  T& operator[](size_t index) noexcept;
+  const T& operator[](size_t index) const noexcept;
+  void Reserve(size_t new_capacity);
+  void MoveCursor(size_t pos);
+  // Вставляет элемент перед курсором, курсор сдвигается за него
+  void Insert(const T& value);
+  void Insert(T&& value);
+  template <typename... Args>
+  T& Emplace(Args&&... args);
+  // Удаляет элемент, следующий за курсором
+  void Erase();
+  // Удаляет элемент, предшествующий курсору
+  void EraseBefore();
+  void Swap(GapVector& other) noexcept;
+
+  iterator begin() noexcept;
+  iterator end() noexcept;
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend() const noexcept;
+
+ private:
+  size_t GapSize() const noexcept;
+  void Reallocate(RawMemory<T>& new_data);
+
+  RawMemory<T> data_;
+  size_t gap_begin_ = 0;
+  size_t gap_end_ = 0;
+};
+
+template <typename T>
+template <bool IsConst>
+class GapVector<T>::BasicIterator {
+  using Container = std::conditional_t<IsConst, const GapVector, GapVector>;
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t<IsConst, const T*, T*>;
+  using reference = std::conditional_t<IsConst, const T&, T&>;
+
+  BasicIterator() = default;
+  BasicIterator(Container* container, size_t index) noexcept
+      : container_(container), index_(index) {}
+  // Неконстантный итератор неявно приводится к константному
+  template <bool OtherConst,
+            typename = std::enable_if_t<IsConst && !OtherConst>>
+  BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+      : container_(other.container_), index_(other.index_) {}
+
+  reference operator*() const noexcept { return (*container_)[index_]; }
+  pointer operator->() const noexcept { return &**this; }
+
+  BasicIterator& operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+  BasicIterator operator++(int) noexcept {
+    auto old = *this;
+    ++index_;
+    return old;
+  }
+  BasicIterator& operator--() noexcept {
+    --index_;
+    return *this;
+  }
+  BasicIterator operator--(int) noexcept {
+    auto old = *this;
+    --index_;
+    return old;
+  }
+
+  bool operator==(const BasicIterator& rhs) const noexcept {
+    return container_ == rhs.container_ && index_ == rhs.index_;
+  }
+  bool operator!=(const BasicIterator& rhs) const noexcept {
+    return !(*this == rhs);
+  }
+
+ private:
+  friend class BasicIterator<!IsConst>;
+
+  Container* container_ = nullptr;
+  size_t index_ = 0;
+};
+
+template <typename T>
+GapVector<T>::GapVector(const GapVector& other)
+    : data_{other.Size()}, gap_begin_{other.Size()}, gap_end_{other.Size()} {
+  std::uninitialized_copy(other.begin(), other.end(), data_.GetAddress());
+}
+
+template <typename T>
+GapVector<T>::GapVector(GapVector&& other) noexcept {
+  Swap(other);
+}
+
+template <typename T>
+GapVector<T>& GapVector<T>::operator=(const GapVector& rhs) {
+  if (this != &rhs) {
+    GapVector rhs_copy(rhs);
+    Swap(rhs_copy);
+  }
+  return *this;
+}
+
+template <typename T>
+GapVector<T>& GapVector<T>::operator=(GapVector&& rhs) noexcept {
+  if (this != &rhs) {
+    Swap(rhs);
+  }
+  return *this;
+}
+
+template <typename T>
+GapVector<T>::~GapVector() {
+  std::destroy_n(data_.GetAddress(), gap_begin_);
+  std::destroy(data_ + gap_end_, data_ + data_.Capacity());
+}
+
+template <typename T>
+size_t GapVector<T>::Size() const noexcept {
+  return data_.Capacity() - GapSize();
+}
+
+template <typename T>
+size_t GapVector<T>::Capacity() const noexcept {
+  return data_.Capacity();
+}
+
+template <typename T>
+size_t GapVector<T>::Cursor() const noexcept {
+  return gap_begin_;
+}
+
+template <typename T>
+const T& GapVector<T>::operator[](size_t index) const noexcept {
+  return const_cast<GapVector&>(*this)[index];
+}
+
+template <typename T>
+T& GapVector<T>::operator[](size_t index) noexcept {
+  assert(index < Size());
+  return index < gap_begin_ ? data_[index] : data_[index + GapSize()];
+}
+
+template <typename T>
+void GapVector<T>::Reserve(size_t new_capacity) {
+  if (new_capacity <= data_.Capacity()) {
+    return;
+  }
+  RawMemory<T> new_data{new_capacity};
+  Reallocate(new_data);
+}
+
+template <typename T>
+void GapVector<T>::MoveCursor(size_t pos) {
+  assert(pos <= Size());
+  if (GapSize() == 0) {
+    gap_begin_ = gap_end_ = pos;
+    return;
+  }
+  // Элементы переносятся по одному, а границы разрыва сдвигаются после каждого
+  // шага, поэтому при исключении контейнер остаётся согласованным
+  while (gap_begin_ > pos) {
+    new (data_ + gap_end_ - 1) T(std::move_if_noexcept(data_[gap_begin_ - 1]));
+    std::destroy_at(data_ + gap_begin_ - 1);
+    --gap_begin_;
+    --gap_end_;
+  }
+  while (gap_begin_ < pos) {
+    new (data_ + gap_begin_) T(std::move_if_noexcept(data_[gap_end_]));
+    std::destroy_at(data_ + gap_end_);
+    ++gap_begin_;
+    ++gap_end_;
+  }
+}
+
+template <typename T>
+void GapVector<T>::Insert(const T& value) {
+  Emplace(value);
+}
+
+template <typename T>
+void GapVector<T>::Insert(T&& value) {
+  Emplace(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+T& GapVector<T>::Emplace(Args&&... args) {
+  if (GapSize() == 0) {
+    RawMemory<T> new_data{data_.Capacity() == 0 ? 1 : data_.Capacity() * 2};
+    new (new_data + gap_begin_) T(std::forward<Args>(args)...);
+    try {
+      Reallocate(new_data);
+    } catch (...) {
+      std::destroy_at(new_data + gap_begin_);
+      throw;
+    }
+  } else {
+    new (data_ + gap_begin_) T(std::forward<Args>(args)...);
+  }
+  return data_[gap_begin_++];
+}
+
+template <typename T>
+void GapVector<T>::Erase() {
+  assert(gap_end_ < data_.Capacity());
+  std::destroy_at(data_ + gap_end_);
+  ++gap_end_;
+}
+
+template <typename T>
+void GapVector<T>::EraseBefore() {
+  assert(gap_begin_ != 0);
+  --gap_begin_;
+  std::destroy_at(data_ + gap_begin_);
+}
+
+template <typename T>
+void GapVector<T>::Swap(GapVector& other) noexcept {
+  data_.Swap(other.data_);
+  std::swap(gap_begin_, other.gap_begin_);
+  std::swap(gap_end_, other.gap_end_);
+}
+
+template <typename T>
+typename GapVector<T>::iterator GapVector<T>::begin() noexcept {
+  return {this, 0};
+}
+
+template <typename T>
+typename GapVector<T>::iterator GapVector<T>::end() noexcept {
+  return {this, Size()};
+}
+
+template <typename T>
+typename GapVector<T>::const_iterator GapVector<T>::begin() const noexcept {
+  return {this, 0};
+}
+
+template <typename T>
+typename GapVector<T>::const_iterator GapVector<T>::end() const noexcept {
+  return {this, Size()};
+}
+
+template <typename T>
+typename GapVector<T>::const_iterator GapVector<T>::cbegin() const noexcept {
+  return begin();
+}
+
+template <typename T>
+typename GapVector<T>::const_iterator GapVector<T>::cend() const noexcept {
+  return end();
+}
+
+template <typename T>
+size_t GapVector<T>::GapSize() const noexcept {
+  return gap_end_ - gap_begin_;
+}
+
+template <typename T>
+void GapVector<T>::Reallocate(RawMemory<T>& new_data) {
+  // Разрыв остаётся на месте курсора и поглощает всю добавленную ёмкость
+  const size_t back_size = data_.Capacity() - gap_end_;
+  const size_t new_gap_end = new_data.Capacity() - back_size;
+  vector_detail::UninitMoveOrCopy(data_ + 0, data_ + gap_begin_,
+                                  new_data + 0);
+  try {
+    vector_detail::UninitMoveOrCopy(data_ + gap_end_,
+                                    data_ + data_.Capacity(),
+                                    new_data + new_gap_end);
+  } catch (...) {
+    std::destroy_n(new_data.GetAddress(), gap_begin_);
+    throw;
+  }
+  std::destroy_n(data_.GetAddress(), gap_begin_);
+  std::destroy(data_ + gap_end_, data_ + data_.Capacity());
+  data_.Swap(new_data);
+  gap_end_ = new_gap_end;
+}
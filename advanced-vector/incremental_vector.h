@@ -0,0 +1,200 @@
+#pragma once
+#include <cassert>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "vector.h"
+
+// Вектор с ограниченной задержкой добавления. При росте новый буфер
+// выделяется сразу, а старые элементы переносятся в него порциями по
+// MigrationStep при каждом следующем PushBack/EmplaceBack, поэтому ни одна
+// операция не переносит больше MigrationStep элементов. Пока перенос не
+// закончен, элементы [migrated_, old_size_) лежат в старом буфере, остальные —
+// в новом. Перенос успевает закончиться до следующего заполнения буфера:
+// после удвоения ёмкости свободных мест не меньше, чем непереносённых
+// элементов, а каждое добавление уменьшает непереносённые хотя бы на одно.
+// Вне переноса migrated_ == old_size_ == 0.
+template <typename T, size_t MigrationStep = 4>
+class IncrementalVector {
+  static_assert(MigrationStep > 0);
+
+ public:
+  IncrementalVector() = default;
+  IncrementalVector(const IncrementalVector&) = delete;
+  IncrementalVector& operator=(const IncrementalVector&) = delete;
+  IncrementalVector(IncrementalVector&& other) noexcept;
+  IncrementalVector& operator=(IncrementalVector&& rhs) noexcept;
+  ~IncrementalVector();
+
+  size_t Size() const noexcept;
+  size_t Capacity() const noexcept;
+  bool IsMigrating() const noexcept;
+  T& operator[](size_t index) noexcept;
+  const T& operator[](size_t index) const noexcept;
+  void PushBack(const T& value);
+  void PushBack(T&& value);
+  template <typename... Args>
+  T& EmplaceBack(Args&&... args);
+  void PopBack() noexcept;
+  T& Back() noexcept;
+  // Переносит все оставшиеся элементы сразу
+  void FinishMigration();
+  void Swap(IncrementalVector& other) noexcept;
+
+ private:
+  bool InOldBuffer(size_t index) const noexcept;
+  void Migrate(size_t count);
+
+  RawMemory<T> data_;
+  RawMemory<T> old_data_;
+  size_t size_ = 0;
+  size_t migrated_ = 0;
+  size_t old_size_ = 0;
+};
+
+template <typename T, size_t MigrationStep>
+IncrementalVector<T, MigrationStep>::IncrementalVector(
+    IncrementalVector&& other) noexcept {
+  Swap(other);
+}
+
+template <typename T, size_t MigrationStep>
+IncrementalVector<T, MigrationStep>&
+IncrementalVector<T, MigrationStep>::operator=(
+    IncrementalVector&& rhs) noexcept {
+  if (this != &rhs) {
+    Swap(rhs);
+  }
+  return *this;
+}
+
+template <typename T, size_t MigrationStep>
+IncrementalVector<T, MigrationStep>::~IncrementalVector() {
+  std::destroy_n(data_.GetAddress(), migrated_);
+  std::destroy(old_data_ + migrated_, old_data_ + old_size_);
+  std::destroy(data_ + old_size_, data_ + size_);
+}
+
+template <typename T, size_t MigrationStep>
+size_t IncrementalVector<T, MigrationStep>::Size() const noexcept {
+  return size_;
+}
+
+template <typename T, size_t MigrationStep>
+size_t IncrementalVector<T, MigrationStep>::Capacity() const noexcept {
+  return data_.Capacity();
+}
+
+template <typename T, size_t MigrationStep>
+bool IncrementalVector<T, MigrationStep>::IsMigrating() const noexcept {
+  return migrated_ != old_size_;
+}
+
+template <typename T, size_t MigrationStep>
+const T& IncrementalVector<T, MigrationStep>::operator[](
+    size_t index) const noexcept {
+  return const_cast<IncrementalVector&>(*this)[index];
+}
+
+template <typename T, size_t MigrationStep>
+T& IncrementalVector<T, MigrationStep>::operator[](size_t index) noexcept {
+  assert(index < size_);
+  return InOldBuffer(index) ? old_data_[index] : data_[index];
+}
+
+template <typename T, size_t MigrationStep>
+void IncrementalVector<T, MigrationStep>::PushBack(const T& value) {
+  EmplaceBack(value);
+}
+
+template <typename T, size_t MigrationStep>
+void IncrementalVector<T, MigrationStep>::PushBack(T&& value) {
+  EmplaceBack(std::move(value));
+}
+
+template <typename T, size_t MigrationStep>
+template <typename... Args>
+T& IncrementalVector<T, MigrationStep>::EmplaceBack(Args&&... args) {
+  if (size_ == data_.Capacity()) {
+    // Перенос всегда заканчивается раньше, чем заполняется буфер
+    assert(!IsMigrating());
+    RawMemory<T> new_data{size_ == 0 ? 1 : size_ * 2};
+    new (new_data + size_) T(std::forward<Args>(args)...);
+    data_.Swap(new_data);
+    old_data_ = std::move(new_data);
+    migrated_ = 0;
+    old_size_ = size_;
+  } else {
+    new (data_ + size_) T(std::forward<Args>(args)...);
+  }
+  // Каждый шаг переноса атомарен, а новый элемент учитывается в size_ только
+  // после переноса, поэтому при исключении он удаляется и элементы вектора
+  // не меняются. Уже начатый перенос продолжится при следующем добавлении
+  try {
+    Migrate(MigrationStep);
+  } catch (...) {
+    std::destroy_at(data_ + size_);
+    throw;
+  }
+  ++size_;
+  return Back();
+}
+
+template <typename T, size_t MigrationStep>
+void IncrementalVector<T, MigrationStep>::PopBack() noexcept {
+  assert(size_ != 0);
+  --size_;
+  if (InOldBuffer(size_)) {
+    std::destroy_at(old_data_ + size_);
+    old_size_ = size_;
+  } else {
+    std::destroy_at(data_ + size_);
+    if (size_ < old_size_) {
+      // Удалён уже перенесённый элемент, значит перенесены все, а старый
+      // буфер освободит следующий Migrate
+      old_size_ = migrated_ = 0;
+    }
+  }
+}
+
+template <typename T, size_t MigrationStep>
+T& IncrementalVector<T, MigrationStep>::Back() noexcept {
+  return (*this)[size_ - 1];
+}
+
+template <typename T, size_t MigrationStep>
+void IncrementalVector<T, MigrationStep>::FinishMigration() {
+  Migrate(old_size_ - migrated_);
+}
+
+template <typename T, size_t MigrationStep>
+void IncrementalVector<T, MigrationStep>::Swap(
+    IncrementalVector& other) noexcept {
+  data_.Swap(other.data_);
+  old_data_.Swap(other.old_data_);
+  std::swap(size_, other.size_);
+  std::swap(migrated_, other.migrated_);
+  std::swap(old_size_, other.old_size_);
+}
+
+template <typename T, size_t MigrationStep>
+bool IncrementalVector<T, MigrationStep>::InOldBuffer(
+    size_t index) const noexcept {
+  return index >= migrated_ && index < old_size_;
+}
+
+template <typename T, size_t MigrationStep>
+void IncrementalVector<T, MigrationStep>::Migrate(size_t count) {
+  for (; count != 0 && migrated_ != old_size_; --count) {
+    vector_detail::UninitMoveOrCopy(old_data_ + migrated_,
+                                    old_data_ + migrated_ + 1,
+                                    data_ + migrated_);
+    std::destroy_at(old_data_ + migrated_);
+    ++migrated_;
+  }
+  if (!IsMigrating() && old_data_.Capacity() != 0) {
+    RawMemory<T>().Swap(old_data_);
+    migrated_ = old_size_ = 0;
+  }
+}
@@ -1,9 +1,44 @@
+#include "bit_vector.h"
+#include "buffer_cache.h"
+#include "capacity_hints.h"
+#include "compact_vector.h"
+#include "deferred_destruction.h"
+#include "flat_map.h"
+#include "flat_set.h"
+#include "gap_vector.h"
+#include "incremental_vector.h"
+#include "matrix.h"
+#include "packed_int_vector.h"
+#include "parallel_algorithm.h"
+#include "priority_queue.h"
+#include "ring_vector.h"
+#include "slot_map.h"
+#include "span.h"
+#include "spsc_ring.h"
 #include "vector.h"
+#include "vector_stats.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -559,6 +594,1627 @@ void Test6() {
     }
 }
 
+void Test7() {
+    const size_t SIZE = 100;
+    {
+        GapVector<int> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.Insert(static_cast<int>(i));
+        }
+        assert(v.Size() == SIZE);
+        assert(v.Cursor() == SIZE);
+        v.MoveCursor(SIZE / 2);
+        v.Insert(-1);
+        assert(v.Size() == SIZE + 1);
+        assert(v.Cursor() == SIZE / 2 + 1);
+        assert(v[SIZE / 2 - 1] == static_cast<int>(SIZE / 2 - 1));
+        assert(v[SIZE / 2] == -1);
+        assert(v[SIZE / 2 + 1] == static_cast<int>(SIZE / 2));
+        v.Erase();
+        assert(v[SIZE / 2 + 1] == static_cast<int>(SIZE / 2 + 1));
+        v.EraseBefore();
+        assert(v.Size() == SIZE - 1);
+        assert(v[SIZE / 2] == static_cast<int>(SIZE / 2 + 1));
+        v.MoveCursor(0);
+        v.Insert(-2);
+        assert(v[0] == -2);
+        int expected_sum = -2;
+        for (size_t i = 0; i < SIZE; ++i) {
+            expected_sum += i == SIZE / 2 ? 0 : static_cast<int>(i);
+        }
+        int sum = 0;
+        for (int x : v) {
+            sum += x;
+        }
+        assert(sum == expected_sum);
+        const auto& cv = v;
+        assert(std::distance(cv.begin(), cv.end()) == static_cast<std::ptrdiff_t>(v.Size()));
+    }
+    {
+        Obj::ResetCounters();
+        {
+            GapVector<Obj> v;
+            v.Reserve(SIZE);
+            for (size_t i = 0; i < SIZE; ++i) {
+                v.Emplace(static_cast<int>(i));
+            }
+            v.MoveCursor(SIZE / 2);
+            assert(Obj::num_moved == 0);
+            assert(Obj::num_copied == 0);
+            auto v_copy(v);
+            assert(v_copy.Size() == SIZE);
+            assert(v_copy[SIZE / 2].id == static_cast<int>(SIZE / 2));
+            // Рост сохраняет курсор и порядок элементов
+            v.Emplace(-1);
+            assert(v.Capacity() == SIZE * 2);
+            assert(v[SIZE / 2].id == -1);
+            assert(v[SIZE].id == static_cast<int>(SIZE - 1));
+            assert(Obj::GetAliveObjectCount() == SIZE * 2 + 1);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        GapVector<TestObj> v;
+        v.Insert(TestObj{});
+        assert(v.Size() == v.Capacity());
+        // Вставка существующего элемента должна быть безопасна даже при реаллокации
+        v.Insert(v[0]);
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+    }
+}
+
+void Test8() {
+    const size_t SIZE = 10;
+#ifdef ADVANCED_VECTOR_STATS
+    ResetGlobalVectorStats();
+    {
+        Vector<Obj> v(SIZE);
+        v.PushBack(Obj{1});
+        v.Reserve(SIZE * 4);
+        const VectorStats stats = v.Stats();
+        assert(stats.reallocations == 2);
+        assert(stats.bytes_allocated == (SIZE + SIZE * 2 + SIZE * 4) * sizeof(Obj));
+        assert(stats.bytes_freed == (SIZE + SIZE * 2) * sizeof(Obj));
+        assert(stats.moved_elements == SIZE + SIZE + 1);
+        assert(stats.copied_elements == 0);
+        assert(stats.peak_capacity == SIZE * 4 * sizeof(Obj));
+        assert(stats.slack_bytes == (SIZE * 4 - SIZE - 1) * sizeof(Obj));
+
+        const VectorStats global = GlobalVectorStats();
+        assert(global.reallocations == 2);
+        assert(global.peak_capacity == SIZE * 4 * sizeof(Obj));
+        assert(global.slack_bytes == stats.slack_bytes);
+
+        Vector<Obj> v_copy;
+        v_copy = v;
+        assert(v_copy.Stats().bytes_allocated == (SIZE + 1) * sizeof(Obj));
+        assert(v_copy.Stats().reallocations == 0);
+
+        std::ostringstream out;
+        out << stats;
+        assert(out.str().find(std::string("peak capacity: ") + std::to_string(SIZE * 4 * sizeof(Obj))) != std::string::npos);
+    }
+    {
+        const VectorStats global = GlobalVectorStats();
+        assert(global.bytes_allocated == global.bytes_freed);
+        assert(global.slack_bytes == 0);
+    }
+#else
+    // Без инструментации вектор не хранит счётчиков и возвращает нули
+    static_assert(sizeof(Vector<int>) == sizeof(RawMemory<int>) + sizeof(size_t));
+    Vector<int> v(SIZE);
+    v.PushBack(1);
+    assert(v.Stats().reallocations == 0);
+    assert(GlobalVectorStats().bytes_allocated == 0);
+#endif
+}
+
+// Элемент для сравнения Vector и std::vector по количеству операций.
+// NothrowMove определяет, перемещаются или копируются элементы при
+// перевыделении памяти
+template <bool NothrowMove>
+struct Counted {
+    Counted() noexcept {
+        ++counts.constructions;
+    }
+    explicit Counted(int value) noexcept
+        : value(value)  //
+    {
+        ++counts.constructions;
+    }
+    Counted(const Counted& other) noexcept
+        : value(other.value)  //
+    {
+        ++counts.copies;
+    }
+    Counted(Counted&& other) noexcept(NothrowMove)
+        : value(other.value)  //
+    {
+        ++counts.moves;
+    }
+    Counted& operator=(const Counted& other) noexcept {
+        value = other.value;
+        ++counts.copy_assignments;
+        return *this;
+    }
+    Counted& operator=(Counted&& other) noexcept(NothrowMove) {
+        value = other.value;
+        ++counts.move_assignments;
+        return *this;
+    }
+
+    struct Counts {
+        size_t constructions = 0;
+        size_t copies = 0;
+        size_t moves = 0;
+        size_t copy_assignments = 0;
+        size_t move_assignments = 0;
+        size_t allocations = 0;
+    };
+
+    int value = 0;
+    static inline Counts counts;
+};
+
+enum class ParityOp { EMPLACE, INSERT, ERASE, PUSH_BACK, POP_BACK, RESIZE, RESERVE, COPY_ASSIGN, MOVE_ASSIGN };
+
+struct ParityStep {
+    ParityOp op;
+    size_t pos;
+    size_t count;
+    int value;
+};
+
+// Vector и контейнеры с тем же интерфейсом
+template <typename Container>
+void ApplyParityStep(Container& v, const ParityStep& step) {
+    using T = std::remove_reference_t<decltype(*v.begin())>;
+    const size_t pos = v.Size() == 0 ? 0 : step.pos % (v.Size() + 1);
+    switch (step.op) {
+        case ParityOp::EMPLACE:
+            v.Emplace(v.cbegin() + pos, step.value);
+            break;
+        case ParityOp::INSERT: {
+            const T value(step.value);
+            v.Insert(v.cbegin() + pos, value);
+            break;
+        }
+        case ParityOp::ERASE:
+            if (pos < v.Size()) {
+                v.Erase(v.cbegin() + pos);
+            }
+            break;
+        case ParityOp::PUSH_BACK:
+            v.PushBack(T(step.value));
+            break;
+        case ParityOp::POP_BACK:
+            if (v.Size() != 0) {
+                v.PopBack();
+            }
+            break;
+        case ParityOp::RESIZE:
+            v.Resize(step.count);
+            break;
+        case ParityOp::RESERVE:
+            v.Reserve(step.count);
+            break;
+        case ParityOp::COPY_ASSIGN: {
+            const Container source(step.count);
+            v = source;
+            break;
+        }
+        case ParityOp::MOVE_ASSIGN: {
+            Container source(step.count);
+            v = std::move(source);
+            break;
+        }
+    }
+}
+
+template <typename T>
+void ApplyParityStep(std::vector<T>& v, const ParityStep& step) {
+    const size_t pos = v.size() == 0 ? 0 : step.pos % (v.size() + 1);
+    switch (step.op) {
+        case ParityOp::EMPLACE:
+            v.emplace(v.cbegin() + pos, step.value);
+            break;
+        case ParityOp::INSERT: {
+            const T value(step.value);
+            v.insert(v.cbegin() + pos, value);
+            break;
+        }
+        case ParityOp::ERASE:
+            if (pos < v.size()) {
+                v.erase(v.cbegin() + pos);
+            }
+            break;
+        case ParityOp::PUSH_BACK:
+            v.push_back(T(step.value));
+            break;
+        case ParityOp::POP_BACK:
+            if (!v.empty()) {
+                v.pop_back();
+            }
+            break;
+        case ParityOp::RESIZE:
+            v.resize(step.count);
+            break;
+        case ParityOp::RESERVE:
+            v.reserve(step.count);
+            break;
+        case ParityOp::COPY_ASSIGN: {
+            const std::vector<T> source(step.count);
+            v = source;
+            break;
+        }
+        case ParityOp::MOVE_ASSIGN: {
+            std::vector<T> source(step.count);
+            v = std::move(source);
+            break;
+        }
+    }
+}
+
+template <typename Container>
+size_t ParityCapacity(const Container& v) {
+    return v.Capacity();
+}
+
+template <typename T>
+size_t ParityCapacity(const std::vector<T>& v) {
+    return v.capacity();
+}
+
+// Выполняет шаг над контейнером и возвращает затраченные операции элемента.
+// Выделение памяти фиксируется по изменению ёмкости
+template <typename T, typename Container>
+typename T::Counts CountParityStep(Container& v, const ParityStep& step) {
+    T::counts = {};
+    const size_t old_capacity = ParityCapacity(v);
+    ApplyParityStep(v, step);
+    auto counts = T::counts;
+    counts.allocations = ParityCapacity(v) != old_capacity;
+    return counts;
+}
+
+template <bool NothrowMove, typename Container = Vector<Counted<NothrowMove>>>
+void RunParity(std::mt19937& generator, size_t num_sequences, size_t sequence_length) {
+    using T = Counted<NothrowMove>;
+    std::uniform_int_distribution<int> op_dist(0, static_cast<int>(ParityOp::MOVE_ASSIGN));
+    std::uniform_int_distribution<size_t> pos_dist(0, 1000);
+    std::uniform_int_distribution<size_t> count_dist(0, 40);
+    for (size_t sequence = 0; sequence < num_sequences; ++sequence) {
+        Container v;
+        std::vector<T> std_v;
+        for (size_t i = 0; i < sequence_length; ++i) {
+            const ParityStep step{static_cast<ParityOp>(op_dist(generator)), pos_dist(generator),
+                                  count_dist(generator), static_cast<int>(i)};
+            const auto counts = CountParityStep<T>(v, step);
+            const auto std_counts = CountParityStep<T>(std_v, step);
+            assert(counts.constructions <= std_counts.constructions);
+            assert(counts.copies <= std_counts.copies);
+            assert(counts.moves <= std_counts.moves);
+            assert(counts.copy_assignments <= std_counts.copy_assignments);
+            assert(counts.move_assignments <= std_counts.move_assignments);
+            assert(counts.allocations <= std_counts.allocations);
+            assert(v.Size() == std_v.size());
+            assert(std::equal(v.begin(), v.end(), std_v.begin(), [](const T& lhs, const T& rhs) {
+                return lhs.value == rhs.value;
+            }));
+        }
+    }
+}
+
+void Test9() {
+    const size_t NUM_SEQUENCES = 200;
+    const size_t SEQUENCE_LENGTH = 100;
+    std::mt19937 generator(42);
+    RunParity<true>(generator, NUM_SEQUENCES, SEQUENCE_LENGTH);
+    RunParity<false>(generator, NUM_SEQUENCES, SEQUENCE_LENGTH);
+}
+
+void Test10() {
+    using namespace std::literals;
+    {
+        FlatSet<int> s;
+        assert(s.Insert(5).second);
+        assert(s.Insert(1).second);
+        assert(s.Insert(3).second);
+        assert(!s.Insert(3).second);
+        assert(s.Size() == 3);
+        assert(std::is_sorted(s.begin(), s.end()));
+        assert(s.Contains(3));
+        assert(!s.Contains(4));
+        assert(*s.LowerBound(4) == 5);
+        assert(s.Erase(3) == 1);
+        assert(s.Erase(3) == 0);
+
+        const std::vector<int> values{9, 5, 7, 0, 7, 2};
+        s.InsertRange(values.begin(), values.end());
+        const std::vector<int> expected{0, 1, 2, 5, 7, 9};
+        assert(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+    }
+    {
+        FlatMap<std::string, int, std::less<>> m;
+        m["b"s] = 2;
+        m["a"s] = 1;
+        ++m["b"s];
+        assert(m.Size() == 2);
+        assert(m.begin()->first == "a"s);
+        // Поиск без создания временной строки
+        assert(m.Find("b"sv)->second == 3);
+        assert(m.Contains("a"));
+        assert(!m.Contains("c"sv));
+        assert(m.At("a"s) == 1);
+        try {
+            m.At("c"s);
+            assert(false && "Exception is expected");
+        } catch (const std::out_of_range&) {
+        }
+
+        // Уже имеющиеся ключи не перезаписываются, из повторов в диапазоне
+        // побеждает первый
+        const std::vector<std::pair<std::string, int>> items{{"c"s, 30}, {"a"s, 10}, {"c"s, 31}};
+        m.InsertRange(items.begin(), items.end());
+        assert(m.Size() == 3);
+        assert(m.At("a"s) == 1);
+        assert(m.At("c"s) == 30);
+        assert(m.Emplace("d"s, 4).second);
+        assert(!m.Emplace("d"s, 5).second);
+        assert(m.Find("d"s)->second == 4);
+
+        // Ключ через итератор доступен только для чтения, значение изменяемо
+        using Reference = decltype(*m.begin());
+        static_assert(std::is_same_v<decltype(m.begin()->first), const std::string&>);
+        static_assert(!std::is_assignable_v<decltype((m.begin()->first)), std::string>);
+        static_assert(!std::is_assignable_v<decltype((std::declval<Reference>().first)), std::string>);
+        static_assert(std::is_same_v<decltype(std::as_const(m).begin()->second), const int&>);
+        for (auto [key, value] : m) {
+            value += 100;
+        }
+        m.begin()->second -= 100;
+        assert(m.At("a"s) == 1 && m.At("d"s) == 104);
+        decltype(m)::const_iterator it = m.Find("c"s);
+        assert(it != m.end() && it - m.cbegin() == 2 && (it + 1)->first == "d"s);
+        assert(m.Erase(it) == m.begin() + 2 && m.Size() == 3);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            FlatMap<int, Obj> m;
+            std::vector<std::pair<int, Obj>> items;
+            for (int i = 0; i < 10; ++i) {
+                items.emplace_back(9 - i, Obj{i});
+            }
+            m.Reserve(items.size());
+            const int old_copy_count = Obj::num_copied;
+            m.InsertRange(std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+            assert(Obj::num_copied == old_copy_count);
+            assert(m.begin()->first == 0);
+            assert(m.begin()->second.id == 9);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test11() {
+    const size_t SIZE = 200;
+    {
+        BitVector bits;
+        for (size_t i = 0; i < SIZE; ++i) {
+            bits.PushBack(i % 3 == 0);
+        }
+        assert(bits.Size() == SIZE);
+        assert(bits.Capacity() == 256);
+        assert(bits[0] && !bits[1] && bits[3]);
+        assert(bits.Count() == (SIZE + 2) / 3);
+        bits[1] = true;
+        bits[0] = false;
+        assert(bits[1] && !bits[0]);
+        assert(bits.FindFirst() == 1);
+        assert(bits.FindNext(2) == 3);
+        assert(bits.FindNext(199) == BitVector::npos);
+        bits[SIZE - 1].Flip();
+        assert(bits.FindNext(199) == 199);
+        bits.PopBack();
+        assert(bits.Size() == SIZE - 1);
+        bits.PushBack(false);
+        assert(!bits[SIZE - 1]);
+    }
+    {
+        BitVector bits(70, true);
+        assert(bits.Count() == 70);
+        bits.Resize(65);
+        assert(bits.Count() == 65);
+        // Отброшенные биты не должны вернуться при росте
+        bits.Resize(130);
+        assert(bits.Count() == 65);
+        assert(bits.FindNext(65) == BitVector::npos);
+        bits.Resize(140, true);
+        assert(bits.Count() == 75);
+        assert(bits.FindNext(65) == 130);
+    }
+    {
+        BitVector a(SIZE);
+        BitVector b(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            a[i] = i % 2 == 0;
+            b[i] = i % 4 == 0;
+        }
+        assert((a & b).Count() == SIZE / 4);
+        assert((a | b).Count() == SIZE / 2);
+        assert((a ^ b).Count() == SIZE / 4);
+        BitVector c = a;
+        c ^= a;
+        assert(c.Count() == 0);
+        assert(c.FindFirst() == BitVector::npos);
+        assert(a.Count() == SIZE / 2);
+    }
+}
+
+void Test12() {
+    const size_t SIZE = 1000;
+    {
+        PackedIntVector v;
+        for (size_t i = 0; i < 10; ++i) {
+            v.PushBack(0);
+        }
+        assert(v.BitWidth() == 0);
+        assert(v[9] == 0);
+        v.PushBack(5);
+        assert(v.BitWidth() == 3);
+        std::vector<uint64_t> expected(10, 0);
+        expected.push_back(5);
+        for (size_t i = 0; i < SIZE; ++i) {
+            const uint64_t value = (i * 2654435761u) % (i < SIZE / 2 ? 1000 : 1'000'000);
+            v.PushBack(value);
+            expected.push_back(value);
+        }
+        v.PushBack(~uint64_t{0});
+        expected.push_back(~uint64_t{0});
+        assert(v.BitWidth() == 64);
+        assert(v.Size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(v[i] == expected[i]);
+        }
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        std::vector<uint64_t> decoded(expected.size() - 7);
+        v.Decode(7, decoded.size(), decoded.data());
+        assert(std::equal(decoded.begin(), decoded.end(), expected.begin() + 7));
+    }
+    {
+        PackedIntVector v(17);
+        v.Reserve(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i * 100);
+        }
+        assert(v.BitWidth() == 17);
+        assert(v.MemoryBytes() < SIZE * sizeof(uint64_t) / 3);
+        assert(v[SIZE - 1] == (SIZE - 1) * 100);
+    }
+    {
+        SortedPackedIntVector v;
+        std::vector<uint64_t> expected;
+        uint64_t value = uint64_t{1} << 40;
+        for (size_t i = 0; i < SIZE; ++i) {
+            // Встречаются и блоки из одинаковых значений
+            value += i < 300 ? 0 : i % 7;
+            v.PushBack(value);
+            expected.push_back(value);
+        }
+        assert(v.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == expected[i]);
+        }
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        std::vector<uint64_t> decoded(SIZE - 100);
+        v.Decode(100, decoded.size(), decoded.data());
+        assert(std::equal(decoded.begin(), decoded.end(), expected.begin() + 100));
+        assert(v.MemoryBytes() < SIZE * sizeof(uint64_t) / 2);
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 100;
+    {
+        // Кэш включается, пока жив буфер, выделенный без него: при освобождении
+        // буфер попадает в кэш и должен вмещать весь свой класс размеров
+        {
+            Vector<int> v;
+            v.Reserve(24);
+            BufferCache::SetEnabled(true);
+        }
+        Vector<int> v;
+        v.Reserve(32);
+        for (int i = 0; i < 32; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 32 && v.Back() == 31);
+    }
+    {
+        const int* address = nullptr;
+        {
+            Vector<int> v(SIZE);
+            address = &v[0];
+        }
+        const auto stats = BufferCache::ThreadStats();
+        // Буфер того же класса размеров берётся из кэша потока
+        Vector<int> v(SIZE + 10);
+        assert(&v[0] == address);
+        assert(BufferCache::ThreadStats().hits == stats.hits + 1);
+    }
+    {
+        // Буферы, освобождённые в другом потоке, возвращаются в оборот через склад
+        const size_t NUM_VECTORS = 64;
+        std::vector<Vector<std::string>> vectors;
+        for (size_t i = 0; i < NUM_VECTORS; ++i) {
+            vectors.emplace_back(SIZE * 2).PushBack("x");
+        }
+        std::thread([&vectors] {
+            vectors.clear();
+        }).join();
+        const auto stats = BufferCache::ThreadStats();
+        for (size_t i = 0; i < NUM_VECTORS; ++i) {
+            vectors.emplace_back(SIZE * 4);
+        }
+        assert(BufferCache::ThreadStats().hits > stats.hits);
+        assert(vectors.back().Size() == SIZE * 4);
+    }
+    BufferCache::Trim();
+    BufferCache::SetEnabled(false);
+}
+
+void Test14() {
+    const size_t SIZE = 1000;
+    {
+        Obj::ResetCounters();
+        {
+            IncrementalVector<Obj, 2> v;
+            for (size_t i = 0; i < SIZE; ++i) {
+                const int old_num_moved = Obj::num_moved;
+                v.EmplaceBack(static_cast<int>(i));
+                // Одно добавление переносит не больше двух элементов
+                assert(Obj::num_moved - old_num_moved <= 2);
+                for (size_t j = 0; j <= i; j += 97) {
+                    assert(v[j].id == static_cast<int>(j));
+                }
+                assert(v.Back().id == static_cast<int>(i));
+            }
+            assert(v.Size() == SIZE);
+            assert(v.Capacity() == 1024);
+            assert(!v.IsMigrating());
+            assert(Obj::num_copied == 0);
+
+            // Удаление во время переноса
+            while (!v.IsMigrating()) {
+                v.EmplaceBack(-1);
+            }
+            assert(v.Capacity() == 2048);
+            while (v.Size() > SIZE / 2) {
+                v.PopBack();
+            }
+            assert(v.Back().id == static_cast<int>(SIZE / 2 - 1));
+            v.FinishMigration();
+            assert(!v.IsMigrating());
+            for (size_t i = 0; i < v.Size(); ++i) {
+                assert(v[i].id == static_cast<int>(i));
+            }
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE / 2));
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            IncrementalVector<Obj> v;
+            for (size_t i = 0; i < 3; ++i) {
+                v.EmplaceBack(static_cast<int>(i));
+            }
+            // Разрушение вектора посреди переноса
+            v.EmplaceBack(3);
+            v.EmplaceBack(4);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        IncrementalVector<TestObj> v;
+        v.PushBack(TestObj{});
+        assert(v.Size() == v.Capacity());
+        // Добавление существующего элемента должно быть безопасно при росте
+        v.PushBack(v[0]);
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+    }
+    {
+        // Перемещение может бросить исключение, поэтому элементы переносятся копированием
+        struct CopyOnly {
+            explicit CopyOnly(int id)
+                : obj(id)  //
+            {
+            }
+            CopyOnly(const CopyOnly& other) = default;
+            Obj obj;
+        };
+        Obj::ResetCounters();
+        {
+            IncrementalVector<CopyOnly> v;
+            v.EmplaceBack(0);
+            v.EmplaceBack(1);
+            v[0].obj.throw_on_copy = true;
+            try {
+                v.EmplaceBack(2);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            // Добавление, прерванное переносом, не меняет элементы вектора
+            assert(v.Size() == 2);
+            assert(v[0].obj.id == 0 && v.Back().obj.id == 1);
+            assert(Obj::GetAliveObjectCount() == 2);
+            v[0].obj.throw_on_copy = false;
+            v.EmplaceBack(2);
+            assert(!v.IsMigrating());
+            for (size_t i = 0; i < v.Size(); ++i) {
+                assert(v[i].obj.id == static_cast<int>(i));
+            }
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test15() {
+    {
+        Obj::ResetCounters();
+        {
+            RingVector<Obj> ring;
+            std::deque<int> expected;
+            std::mt19937 rng(15);
+            for (int i = 0; i < 2000; ++i) {
+                switch (rng() % 4) {
+                    case 0:
+                        ring.EmplaceBack(i);
+                        expected.push_back(i);
+                        break;
+                    case 1:
+                        ring.EmplaceFront(i);
+                        expected.push_front(i);
+                        break;
+                    case 2:
+                        if (!expected.empty()) {
+                            ring.PopFront();
+                            expected.pop_front();
+                        }
+                        break;
+                    default:
+                        if (!expected.empty()) {
+                            ring.PopBack();
+                            expected.pop_back();
+                        }
+                        break;
+                }
+                assert(ring.Size() == expected.size());
+                if (!expected.empty()) {
+                    assert(ring.Front().id == expected.front());
+                    assert(ring.Back().id == expected.back());
+                }
+            }
+            for (size_t i = 0; i < expected.size(); ++i) {
+                assert(ring[i].id == expected[i]);
+            }
+            // Два участка вместе содержат все элементы по порядку
+            const auto [first, second] = std::as_const(ring).Spans();
+            assert(first.size + second.size == ring.Size());
+            for (size_t i = 0; i < ring.Size(); ++i) {
+                const Obj& obj = i < first.size ? first.data[i] : second.data[i - first.size];
+                assert(obj.id == expected[i]);
+            }
+            assert(Obj::num_copied == 0);
+
+            RingVector<Obj> copy(ring);
+            assert(copy.Size() == ring.Size());
+            assert(copy.Spans().second.size == 0);
+            for (size_t i = 0; i < copy.Size(); ++i) {
+                assert(copy[i].id == expected[i]);
+            }
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(2 * expected.size()));
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Рост при обёрнутых элементах разворачивает их в начало буфера
+        RingVector<int> ring;
+        ring.Reserve(4);
+        for (int i = 0; i < 4; ++i) {
+            ring.PushBack(i);
+        }
+        ring.PopFront();
+        ring.PopFront();
+        ring.PushBack(4);
+        ring.PushBack(5);
+        assert(ring.Spans().second.size == 2);
+        ring.PushFront(1);
+        assert(ring.Capacity() == 8);
+        assert(ring.Spans().second.size == 0);
+        for (size_t i = 0; i < ring.Size(); ++i) {
+            assert(ring[i] == static_cast<int>(i) + 1);
+        }
+    }
+    {
+        RingVector<TestObj> ring;
+        ring.PushBack(TestObj{});
+        // Добавление существующего элемента должно быть безопасно при росте
+        ring.PushBack(ring[0]);
+        ring.PushFront(ring[1]);
+        for (size_t i = 0; i < ring.Size(); ++i) {
+            assert(ring[i].IsAlive());
+        }
+    }
+    {
+        SpscRing<int> queue(3);
+        assert(queue.Capacity() == 4);
+        int value = 0;
+        assert(!queue.TryPop(value));
+        for (int i = 0; i < 4; ++i) {
+            assert(queue.TryPush(i));
+        }
+        assert(!queue.TryPush(4));
+        assert(queue.TryPop(value) && value == 0);
+        assert(queue.TryPush(4));
+        assert(queue.SizeApprox() == 4);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            SpscRing<Obj> queue(4);
+            queue.TryEmplace(1);
+            queue.TryEmplace(2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        const int COUNT = 100'000;
+        SpscRing<int> queue(64);
+        std::thread producer([&] {
+            for (int i = 0; i < COUNT; ++i) {
+                while (!queue.TryPush(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        for (int expected = 0; expected < COUNT;) {
+            int value = 0;
+            if (queue.TryPop(value)) {
+                assert(value == expected);
+                ++expected;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+    }
+}
+
+void Test16() {
+    for (size_t concurrency : {1, 3}) {
+        ThreadPool pool(concurrency);
+        assert(pool.Concurrency() == concurrency);
+        // Меньше порога, на пороге и с неполным последним куском
+        for (size_t size : {size_t{0}, size_t{100}, size_t{65'536}, size_t{300'007}}) {
+            Vector<int> v(size);
+            parallel::Fill(pool, v.begin(), v.end(), 3);
+            assert(std::all_of(v.begin(), v.end(), [](int x) {
+                return x == 3;
+            }));
+
+            std::mt19937 rng(static_cast<unsigned>(size));
+            parallel::ForEach(pool, v.begin(), v.end(), [](int& x) {
+                x *= 2;
+            });
+            assert(std::all_of(v.begin(), v.end(), [](int x) {
+                return x == 6;
+            }));
+            for (int& x : v) {
+                x = static_cast<int>(rng() % 1000);
+            }
+
+            Vector<int64_t> squares(size);
+            const auto squares_end = parallel::Transform(pool, v.begin(), v.end(), squares.begin(), [](int x) {
+                return int64_t{x} * x;
+            });
+            assert(squares_end == squares.end());
+            for (size_t i = 0; i < size; ++i) {
+                assert(squares[i] == int64_t{v[i]} * v[i]);
+            }
+            // Выход без произвольного доступа заполняется последовательно
+            std::vector<int64_t> appended;
+            parallel::Transform(pool, v.begin(), v.end(), std::back_inserter(appended), [](int x) {
+                return int64_t{x} * x;
+            });
+            assert(std::equal(appended.begin(), appended.end(), squares.begin(), squares.end()));
+            assert(parallel::Reduce(pool, squares.begin(), squares.end(), int64_t{7})
+                   == std::accumulate(squares.begin(), squares.end(), int64_t{7}));
+
+            // Неассоциативная конкатенация проверяет порядок объединения кусков
+            std::vector<std::string> words(size / 100);
+            for (size_t i = 0; i < words.size(); ++i) {
+                words[i] = std::to_string(i);
+            }
+            assert(parallel::Reduce(pool, words.begin(), words.end(), std::string{"@"})
+                   == std::accumulate(words.begin(), words.end(), std::string{"@"}));
+
+            std::vector<int> expected(v.begin(), v.end());
+            std::sort(expected.begin(), expected.end(), std::greater<>());
+            parallel::Sort(pool, v.begin(), v.end(), std::greater<>());
+            assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        }
+        {
+            // Исключение из куска перебрасывается вызывающему
+            Vector<int> v(1'000'000);
+            bool thrown = false;
+            try {
+                parallel::ForEach(pool, v.begin(), v.end(), [&v](int& x) {
+                    if (&x == &v[v.Size() / 2]) {
+                        throw std::runtime_error("chunk failed");
+                    }
+                });
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+        {
+            // Вложенные алгоритмы ждут, выполняя задачи пула
+            Vector<Vector<int>> rows(8);
+            for (auto& row : rows) {
+                row.Resize(100'000);
+            }
+            parallel::ForEach(pool, rows.begin(), rows.end(), [&pool](Vector<int>& row) {
+                parallel::Fill(pool, row.begin(), row.end(), 1);
+            });
+            for (const auto& row : rows) {
+                assert(parallel::Reduce(pool, row.begin(), row.end(), 0) == 100'000);
+            }
+        }
+    }
+    {
+        Vector<int> v(200'000);
+        std::iota(v.begin(), v.end(), 0);
+        std::reverse(v.begin(), v.end());
+        parallel::Sort(v.begin(), v.end());
+        assert(std::is_sorted(v.begin(), v.end()));
+    }
+}
+
+struct MallocDeleter {
+    template <typename T>
+    static void Free(T* buffer, size_t /*capacity*/) {
+        ++num_calls;
+        std::free(buffer);
+    }
+
+    static inline int num_calls = 0;
+};
+
+void Test17() {
+    using namespace std::literals;
+    {
+        // Буфер переходит из вектора в вектор без копирования элементов
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (int i = 0; i < 5; ++i) {
+            v.EmplaceBack(i);
+        }
+        const Obj* data = &v[0];
+        const int num_moved = Obj::num_moved;
+        VectorBuffer<Obj> buffer = v.Release();
+        assert(v.Size() == 0 && v.Capacity() == 0);
+        assert(buffer.data == data && buffer.size == 5 && buffer.capacity == 8);
+        assert(buffer.deleter == &RawMemory<Obj>::DefaultDeleter);
+
+        Vector<Obj> adopted = Vector<Obj>::Adopt(buffer.data, buffer.size, buffer.capacity, buffer.deleter);
+        assert(&adopted[0] == data && adopted.Size() == 5 && adopted.Capacity() == 8);
+        assert(Obj::num_moved == num_moved && Obj::num_copied == 0);
+        assert(adopted[4].id == 4);
+        v.EmplaceBack(10);
+        assert(v.Size() == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Чужой буфер освобождается своим deleter, в том числе при росте
+        MallocDeleter::num_calls = 0;
+        auto* raw = static_cast<std::string*>(std::malloc(3 * sizeof(std::string)));
+        for (int i = 0; i < 2; ++i) {
+            new (raw + i) std::string(std::to_string(i));
+        }
+        {
+            auto v = Vector<std::string>::Adopt(raw, 2, 3, &MallocDeleter::Free<std::string>);
+            v.PushBack("2"s);
+            assert(v.Capacity() == 3 && MallocDeleter::num_calls == 0);
+            v.PushBack("3"s);
+            assert(v.Capacity() == 6 && MallocDeleter::num_calls == 1);
+            assert(v[0] == "0"s && v[3] == "3"s);
+        }
+        assert(MallocDeleter::num_calls == 1);
+
+        auto* ints = static_cast<int*>(std::malloc(4 * sizeof(int)));
+        std::iota(ints, ints + 4, 0);
+        {
+            auto v = Vector<int>::Adopt(ints, 4, 4, &MallocDeleter::Free<int>);
+            Vector<int> moved(std::move(v));
+            VectorBuffer<int> buffer = moved.Release();
+            assert(buffer.data == ints && buffer.deleter == &MallocDeleter::Free<int>);
+            buffer.deleter(buffer.data, buffer.capacity);
+        }
+        assert(MallocDeleter::num_calls == 2);
+    }
+    {
+        Vector<int> v(10);
+        std::iota(v.begin(), v.end(), 0);
+        Span span(v);
+        static_assert(std::is_same_v<decltype(span), Span<int>>);
+        assert(span.Data() == v.begin() && span.Size() == 10);
+        span[0] = 100;
+        assert(v[0] == 100);
+
+        const Span<int> middle = span.Subspan(2, 5);
+        assert(middle.Size() == 5 && middle.Front() == 2 && middle.Back() == 6);
+        assert(middle.First(2).Back() == 3 && middle.Last(2).Front() == 5);
+        assert(span.Subspan(10).Empty());
+        assert(std::accumulate(middle.begin(), middle.end(), 0) == 2 + 3 + 4 + 5 + 6);
+
+        const Vector<int>& cv = v;
+        Span const_span(cv);
+        static_assert(std::is_same_v<decltype(const_span), Span<const int>>);
+        Span<const int> converted = middle;
+        assert(converted.Data() == middle.Data());
+        static_assert(!std::is_convertible_v<Span<const int>, Span<int>>);
+
+        const auto slice = Slice(cv, 7, 3);
+        assert(slice.Size() == 3 && slice[0] == 7 && slice.SizeBytes() == 3 * sizeof(int));
+    }
+}
+
+struct ThreadTracked {
+    ~ThreadTracked() {
+        if (std::this_thread::get_id() != owner) {
+            ++num_destroyed_elsewhere;
+        }
+        ++num_destroyed;
+    }
+
+    std::thread::id owner = std::this_thread::get_id();
+    char payload[56] = {};
+
+    static inline std::atomic<int> num_destroyed = 0;
+    static inline std::atomic<int> num_destroyed_elsewhere = 0;
+};
+
+void Test18() {
+    const auto reset = [] {
+        ThreadTracked::num_destroyed = 0;
+        ThreadTracked::num_destroyed_elsewhere = 0;
+    };
+    DeferredDestruction::SetThreshold(64 * 1000);
+    {
+        // Выключено: разрушение синхронное
+        reset();
+        { Vector<ThreadTracked> v(2000); }
+        assert(ThreadTracked::num_destroyed == 2000);
+    }
+    DeferredDestruction::SetEnabled(true);
+#ifdef ADVANCED_VECTOR_DEFERRED_DESTRUCTION
+    {
+        reset();
+        { Vector<ThreadTracked> small(100); }
+        assert(ThreadTracked::num_destroyed == 100);
+
+        {
+            Vector<ThreadTracked> large(2000);
+            Vector<ThreadTracked> other(500);
+            // Старое содержимое уходит в other и разрушается вместе с ним
+            other = std::move(large);
+        }
+        DeferredDestruction::Drain();
+        assert(ThreadTracked::num_destroyed == 2600);
+        assert(ThreadTracked::num_destroyed_elsewhere == 2000);
+    }
+    {
+        // Вложенные векторы разрушаются фоновым потоком сразу
+        Obj::ResetCounters();
+        {
+            Vector<Vector<Obj>> nested(10'000);
+            for (auto& inner : nested) {
+                inner.EmplaceBack(1);
+            }
+            nested[0].Resize(20'000);
+        }
+        DeferredDestruction::Drain();
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Буфер, принятый через Adopt, освобождается своим deleter
+        MallocDeleter::num_calls = 0;
+        const size_t size = 100'000;
+        auto* raw = static_cast<int*>(std::malloc(size * sizeof(int)));
+        { auto v = Vector<int>::Adopt(raw, 0, size, &MallocDeleter::Free<int>); }
+        DeferredDestruction::Drain();
+        assert(MallocDeleter::num_calls == 1);
+    }
+#else
+    {
+        // Без макроса Vector не обращается к DeferredDestruction даже после включения
+        reset();
+        { Vector<ThreadTracked> v(2000); }
+        assert(ThreadTracked::num_destroyed == 2000);
+        assert(ThreadTracked::num_destroyed_elsewhere == 0);
+    }
+#endif
+    DeferredDestruction::SetEnabled(false);
+    DeferredDestruction::SetThreshold(DeferredDestruction::kDefaultThreshold);
+}
+
+void Test19() {
+    static_assert(sizeof(CompactVector<int>) == sizeof(void*));
+    static_assert(sizeof(CompactVector<std::string, uint32_t>) == sizeof(void*));
+    // Заголовок дополняется до выравнивания элементов
+    static_assert(CompactVector<int, uint32_t>::kHeaderBytes == 8);
+    static_assert(CompactVector<char, uint8_t>::kHeaderBytes == 2);
+    static_assert(CompactVector<double, uint8_t>::kHeaderBytes == 8);
+    {
+        Obj::ResetCounters();
+        {
+            CompactVector<Obj> v;
+            assert(v.Size() == 0 && v.Capacity() == 0 && v.begin() == nullptr);
+            for (int i = 0; i < 10; ++i) {
+                v.EmplaceBack(i);
+            }
+            assert(v.Size() == 10 && v.Capacity() == 16);
+            v.Insert(v.begin() + 3, Obj(100));
+            v.Erase(v.begin());
+            assert(v[2].id == 100 && v.Back().id == 9);
+            assert(Obj::num_copied == 0);
+
+            CompactVector<Obj> copy(v);
+            assert(copy.Size() == v.Size() && copy.Capacity() == v.Size());
+            v.Clear();
+            assert(v.Size() == 0 && v.Capacity() == 16);
+            v = copy;
+            assert(v.Size() == 10 && v.Capacity() == 16);
+            for (size_t i = 0; i < v.Size(); ++i) {
+                assert(v[i].id == copy[i].id);
+            }
+            v.Resize(3);
+            v.PopBack();
+            assert(v.Size() == 2);
+            CompactVector<Obj> moved(std::move(copy));
+            assert(copy.Size() == 0 && moved.Size() == 10);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Строгая гарантия: ошибка при копировании элемента не меняет вектор
+        Obj::ResetCounters();
+        {
+            CompactVector<Obj> v;
+            v.Reserve(2);
+            v.EmplaceBack(1);
+            v.EmplaceBack(2);
+            Obj throwing(3);
+            throwing.throw_on_copy = true;
+            try {
+                v.PushBack(throwing);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2 && v.Capacity() == 2 && v[1].id == 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Ёмкость ограничена типом размера
+        CompactVector<uint8_t, uint8_t> v;
+        for (int i = 0; i < 255; ++i) {
+            v.PushBack(static_cast<uint8_t>(i));
+        }
+        assert(v.Size() == 255 && v.Capacity() == 255);
+        bool thrown = false;
+        try {
+            v.PushBack(0);
+        } catch (const std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown && v.Size() == 255);
+    }
+    {
+        std::mt19937 generator(39);
+        RunParity<true, CompactVector<Counted<true>>>(generator, 100, 100);
+        RunParity<false, CompactVector<Counted<false>, uint32_t>>(generator, 100, 100);
+    }
+    {
+        Vector<CompactVector<int, uint32_t>> graph(1000);
+        for (size_t i = 0; i < graph.Size(); i += 10) {
+            graph[i].PushBack(static_cast<int>(i));
+        }
+        assert(graph.Capacity() * sizeof(graph[0]) == 1000 * sizeof(void*));
+        assert(graph[990][0] == 990 && graph[991].Size() == 0);
+    }
+}
+
+void Test20() {
+    using namespace std::literals;
+    {
+        Obj::ResetCounters();
+        {
+            SlotMap<Obj> map;
+            const auto a = map.Emplace(1);
+            const auto b = map.Emplace(2);
+            const auto c = map.Insert(Obj(3));
+            assert(map.Size() == 3);
+            assert(map.Get(b)->id == 2);
+            assert(map.HandleAt(2) == c);
+
+            // Удаление переносит последний элемент на место удалённого
+            assert(map.Erase(a));
+            assert(!map.Contains(a) && map.Get(a) == nullptr);
+            assert(!map.Erase(a));
+            assert(map.Size() == 2);
+            assert(map.begin()->id == 3);
+            assert(map.Get(c)->id == 3 && map.Get(b)->id == 2);
+
+            // Ячейка переиспользуется с новым поколением
+            const auto d = map.Emplace(4);
+            assert(d.index == a.index && d.generation != a.generation);
+            assert(!map.Contains(a) && map.Get(d)->id == 4);
+
+            map.Clear();
+            assert(map.Size() == 0 && !map.Contains(b) && !map.Contains(d));
+            assert(!map.Contains(SlotMapHandle{}));
+            const auto e = map.Emplace(5);
+            assert(map.Get(e)->id == 5 && map.Size() == 1);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Случайная последовательность сверяется с std::map
+        SlotMap<std::string> map;
+        std::map<int, std::pair<SlotMapHandle, std::string>> expected;
+        std::vector<SlotMapHandle> erased;
+        std::mt19937 rng(40);
+        for (int i = 0; i < 5000; ++i) {
+            if (expected.empty() || rng() % 3 != 0) {
+                const auto value = std::to_string(i);
+                expected[i] = {map.Insert(value), value};
+            } else {
+                auto it = expected.begin();
+                std::advance(it, rng() % expected.size());
+                assert(map.Erase(it->second.first));
+                erased.push_back(it->second.first);
+                expected.erase(it);
+            }
+        }
+        assert(map.Size() == expected.size());
+        for (const auto& [key, entry] : expected) {
+            assert(*map.Get(entry.first) == entry.second);
+        }
+        for (const auto& handle : erased) {
+            assert(!map.Contains(handle));
+        }
+        for (size_t i = 0; i < map.Size(); ++i) {
+            assert(map.Get(map.HandleAt(i)) == map.begin() + i);
+        }
+    }
+}
+
+void Test21() {
+    using namespace std::literals;
+    using namespace capacity_hints_detail;
+    // Каждый размер помещается в ёмкость своей корзины с запасом не больше 25%
+    for (size_t size = 0; size < 100'000; ++size) {
+        const size_t capacity = BucketCapacity(BucketIndex(size));
+        assert(capacity >= size && capacity - size <= size / 4);
+        assert(BucketIndex(capacity) == BucketIndex(size));
+    }
+    assert(BucketCapacity(BucketIndex(~size_t{0})) == ~size_t{0});
+
+    const auto build = [](CapacityHintSite& site, size_t size) {
+        HintedVector<int> v(site);
+        const size_t reserved = v.Capacity();
+        for (size_t i = 0; i < size; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        return reserved;
+    };
+
+    CapacityHintSite& site = CapacityHints::Site("test21.site");
+    assert(&site == &CapacityHints::Site("test21.site"));
+    // В выключенном состоянии ничего не резервируется и не записывается
+    assert(build(site, 100) == 0 && site.Samples() == 0);
+
+    CapacityHints::SetEnabled(true);
+    for (size_t i = 0; i < CapacityHints::kMinSamples - 1; ++i) {
+        assert(build(site, 90 + i % 10) == 0);
+    }
+    // После kMinSamples размеров подсказка покрывает 90% векторов
+    build(site, 1000);
+    assert(site.Samples() == CapacityHints::kMinSamples);
+    assert(site.Hint() >= 99 && site.Hint() < 1000);
+    assert(build(site, 95) == site.Hint());
+
+    {
+        // Take записывает размер сразу и отдаёт элементы
+        HintedVector<std::string> hinted(site);
+        hinted.PushBack("a"s);
+        const size_t samples = site.Samples();
+        Vector<std::string> taken = std::move(hinted).Take();
+        assert(site.Samples() == samples + 1);
+        assert(taken.Size() == 1 && taken[0] == "a"s);
+    }
+    assert(site.Samples() == CapacityHints::kMinSamples + 2);
+
+    // Одна строка кода — одно место, разные строки — разные места
+    CapacityHintSite* sites[2];
+    for (int i = 0; i < 2; ++i) {
+        sites[i] = &ADVANCED_VECTOR_HINT_SITE();
+    }
+    CapacityHintSite& other = ADVANCED_VECTOR_HINT_SITE();
+    assert(sites[0] == sites[1] && sites[0] != &other);
+    assert(sites[0]->Key().find("main.cc:") != std::string::npos);
+
+    // Выученные подсказки переживают выгрузку и загрузку
+    std::stringstream dump;
+    CapacityHints::Dump(dump);
+    const std::string line = "test21.site\t"s + std::to_string(site.Hint()) + "\n"s;
+    assert(dump.str().find(line) != std::string::npos);
+    std::stringstream baked("test21.loaded\t500\n\ntest21.loaded2\t7\n");
+    assert(CapacityHints::Load(baked) == 2);
+    CapacityHintSite& loaded = CapacityHints::Site("test21.loaded");
+    assert(loaded.Hint() == 500 && build(loaded, 10) == 500);
+    std::stringstream malformed("test21.bad 12\n");
+    try {
+        CapacityHints::Load(malformed);
+        assert(false);
+    } catch (const std::invalid_argument&) {
+    }
+    CapacityHints::SetEnabled(false);
+
+    {
+        // Записи из нескольких потоков не теряются
+        CapacityHintSite& shared = CapacityHints::Site("test21.threads");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&shared] {
+                for (int i = 0; i < 1000; ++i) {
+                    shared.Record(64);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(shared.Samples() == 4000 && shared.Hint() == BucketCapacity(BucketIndex(64)));
+    }
+}
+
+void Test22() {
+    const auto naive_product = [](const Matrix<int>& lhs, const Matrix<int>& rhs) {
+        Matrix<int> result(lhs.Rows(), rhs.Cols());
+        for (size_t i = 0; i < lhs.Rows(); ++i) {
+            for (size_t j = 0; j < rhs.Cols(); ++j) {
+                for (size_t k = 0; k < lhs.Cols(); ++k) {
+                    result(i, j) += lhs(i, k) * rhs(k, j);
+                }
+            }
+        }
+        return result;
+    };
+    for (const MatrixLayout layout : {MatrixLayout::kRowMajor, MatrixLayout::kTiled}) {
+        // Размеры не кратны стороне плитки, чтобы проверить неполные плитки
+        const size_t rows = 37;
+        const size_t cols = 70;
+        Matrix<int> m(rows, cols, layout);
+        assert(m.Rows() == rows && m.Cols() == cols && m.Layout() == layout);
+        assert(reinterpret_cast<uintptr_t>(&m(0, 0)) % Matrix<int>::kAlignment == 0);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                assert(m(i, j) == 0);
+                m(i, j) = static_cast<int>(i * 1000 + j);
+            }
+        }
+
+        const auto row = m.Row(5);
+        assert(row.Size() == cols);
+        const auto col = std::as_const(m).Col(66);
+        assert(col.Size() == rows);
+        for (size_t j = 0; j < cols; ++j) {
+            assert(row[j] == static_cast<int>(5'000 + j));
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            assert(col[i] == static_cast<int>(i * 1000 + 66));
+        }
+        m.Col(3)[36] = -1;
+        assert(m(36, 3) == -1);
+        m(36, 3) = 36'003;
+
+        assert(m.TileRows() == 2 && m.TileCols() == 3);
+        const MatrixView<const int> tile = std::as_const(m).Tile(1, 2);
+        assert(tile.Rows() == rows - 32 && tile.Cols() == cols - 64);
+        assert(tile(0, 0) == 32'064 && tile(4, 5) == 36'069);
+        assert(tile.Row(2)[1] == 34'065);
+
+        const Matrix<int> other = m.ToLayout(layout == MatrixLayout::kTiled ? MatrixLayout::kRowMajor
+                                                                             : MatrixLayout::kTiled);
+        assert(other == m && other.Layout() != layout);
+
+        const Matrix<int> t = m.Transposed();
+        assert(t.Rows() == cols && t.Cols() == rows && t.Layout() == layout);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                assert(t(j, i) == m(i, j));
+            }
+        }
+        assert(t.Transposed() == m);
+
+        Matrix<int> a(45, 70, layout);
+        Matrix<int> b(70, 33, layout == MatrixLayout::kTiled ? MatrixLayout::kRowMajor : MatrixLayout::kTiled);
+        std::mt19937 rng(42);
+        for (size_t i = 0; i < a.Rows(); ++i) {
+            for (size_t j = 0; j < a.Cols(); ++j) {
+                a(i, j) = static_cast<int>(rng() % 21) - 10;
+            }
+        }
+        for (size_t i = 0; i < b.Rows(); ++i) {
+            for (size_t j = 0; j < b.Cols(); ++j) {
+                b(i, j) = static_cast<int>(rng() % 21) - 10;
+            }
+        }
+        const Matrix<int> product = Multiply(a, b);
+        assert(product.Layout() == layout);
+        assert(product == naive_product(a, b));
+        try {
+            Multiply(a, a);
+            assert(false);
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    {
+        Matrix<double> empty(0, 5, MatrixLayout::kTiled);
+        assert(empty.TileRows() == 0 && empty.Col(4).Size() == 0);
+        assert(Multiply(Matrix<double>(3, 0), Matrix<double>(0, 4)) == Matrix<double>(3, 4));
+        try {
+            Matrix<double>(size_t{1} << 40, size_t{1} << 40);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+    }
+    {
+        // Строка из 64 double занимает 512 байт и дополняется кэш-линией, транспонированная — нет
+        Matrix<double> m(40, 64);
+        const auto row_bytes = [](const Matrix<double>& matrix) {
+            return reinterpret_cast<uintptr_t>(&matrix(1, 0)) - reinterpret_cast<uintptr_t>(&matrix(0, 0));
+        };
+        assert(row_bytes(m) == 512 + 64);
+        for (size_t i = 0; i < m.Rows(); ++i) {
+            for (size_t j = 0; j < m.Cols(); ++j) {
+                m(i, j) = static_cast<double>(i * 100 + j);
+            }
+        }
+        assert(m.Col(63)[39] == 3'963.0 && m.Row(39)[63] == 3'963.0);
+        const Matrix<double> t = m.Transposed();
+        assert(row_bytes(t) == 40 * sizeof(double));
+        assert(t(63, 39) == 3'963.0 && t(1, 2) == 201.0);
+        const Matrix<double> back = t.Transposed();
+        assert(row_bytes(back) == 512 + 64 && back == m);
+        assert(m.ToLayout(MatrixLayout::kTiled).ToLayout(MatrixLayout::kRowMajor) == m);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            Matrix<Obj> m(3, 3, Obj(7), MatrixLayout::kTiled);
+            // Дополнение плиточной раскладки тоже сконструировано
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(kMatrixTileSize * kMatrixTileSize));
+            Matrix<Obj> copy = m;
+            Matrix<Obj> moved = std::move(copy);
+            assert(moved(2, 2).id == 7 && copy.Rows() == 0);
+            copy = moved;
+            assert(copy(1, 1).id == 7);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        Obj::default_construction_throw_countdown = 5;
+        try {
+            Matrix<Obj> m(2, 3);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+template <size_t D>
+void CheckPriorityQueueAgainstStd() {
+    std::mt19937 rng(43);
+    PriorityQueue<int, std::less<int>, D> queue;
+    std::priority_queue<int> expected;
+    for (int i = 0; i < 20'000; ++i) {
+        if (expected.empty() || rng() % 3 != 0) {
+            const int value = static_cast<int>(rng() % 1000);
+            queue.Push(value);
+            expected.push(value);
+        } else {
+            assert(queue.Top() == expected.top());
+            queue.Pop();
+            expected.pop();
+        }
+        assert(queue.Size() == expected.size());
+    }
+    // Большой диапазон перестраивает кучу целиком, маленький просеивается
+    for (const size_t count : {size_t{50'000}, size_t{10}}) {
+        std::vector<int> values(count);
+        for (int& value : values) {
+            value = static_cast<int>(rng() % 100'000);
+            expected.push(value);
+        }
+        queue.PushRange(values.begin(), values.end());
+    }
+    while (!expected.empty()) {
+        assert(queue.Top() == expected.top());
+        queue.Pop();
+        expected.pop();
+    }
+    assert(queue.Empty());
+}
+
+void Test23() {
+    CheckPriorityQueueAgainstStd<2>();
+    CheckPriorityQueueAgainstStd<4>();
+    CheckPriorityQueueAgainstStd<8>();
+    {
+        // Группа детей каждого узла занимает ровно одну кэш-линию, в том числе после
+        // роста и в копии
+        PriorityQueue<uint64_t, std::less<uint64_t>, 8> queue;
+        for (uint64_t i = 0; i < 1000; ++i) {
+            queue.Push(i * 7919 % 1000);
+        }
+        const PriorityQueue<uint64_t, std::less<uint64_t>, 8> copy(queue);
+        const auto check_alignment = [](const auto& q) {
+            for (size_t node = 0; node * 8 + 1 < q.Size(); ++node) {
+                assert(reinterpret_cast<uintptr_t>(&q.At(node * 8 + 1)) % 64 == 0);
+            }
+        };
+        check_alignment(queue);
+        check_alignment(copy);
+        assert(copy.Size() == 1000 && copy.Top() == 999);
+        // Добавление элемента самой очереди при росте буфера
+        PriorityQueue<std::string> strings;
+        strings.Push(std::string(40, 'x'));
+        while (strings.Size() < 100) {
+            strings.Push(strings.Top());
+        }
+        assert(strings.Top() == std::string(40, 'x'));
+    }
+    {
+        PriorityQueue<std::string, std::greater<std::string>, 3> queue;
+        std::istringstream words("pear apple fig banana cherry");
+        queue.PushRange(std::istream_iterator<std::string>(words), std::istream_iterator<std::string>());
+        queue.Emplace(3, 'a');
+        std::vector<std::string> order;
+        while (!queue.Empty()) {
+            order.push_back(queue.Top());
+            queue.Pop();
+        }
+        assert((order == std::vector<std::string>{"aaa", "apple", "banana", "cherry", "fig", "pear"}));
+    }
+    {
+        // Алгоритм Дейкстры с уменьшением расстояния через индекс позиций
+        struct Entry {
+            uint64_t distance;
+            size_t node;
+        };
+        struct ByDistance {
+            bool operator()(const Entry& lhs, const Entry& rhs) const {
+                return lhs.distance > rhs.distance;
+            }
+        };
+        struct Positions {
+            std::vector<size_t>* positions;
+            void operator()(const Entry& entry, size_t position) const {
+                (*positions)[entry.node] = position;
+            }
+        };
+        const size_t num_nodes = 2'000;
+        std::mt19937 rng(44);
+        std::vector<std::vector<std::pair<size_t, uint64_t>>> graph(num_nodes);
+        for (size_t i = 0; i < num_nodes * 8; ++i) {
+            graph[rng() % num_nodes].emplace_back(rng() % num_nodes, rng() % 100 + 1);
+        }
+        std::vector<size_t> positions(num_nodes, kNoHeapPosition);
+        std::vector<uint64_t> distance(num_nodes, std::numeric_limits<uint64_t>::max());
+        PriorityQueue<Entry, ByDistance, 4, Positions> queue(ByDistance{}, Positions{&positions});
+        distance[0] = 0;
+        queue.Push({0, 0});
+        while (!queue.Empty()) {
+            const Entry top = queue.Top();
+            queue.Pop();
+            assert(positions[top.node] == kNoHeapPosition);
+            for (const auto& [to, weight] : graph[top.node]) {
+                if (top.distance + weight < distance[to]) {
+                    distance[to] = top.distance + weight;
+                    if (positions[to] == kNoHeapPosition) {
+                        queue.Push({distance[to], to});
+                    } else {
+                        assert(queue.At(positions[to]).node == to);
+                        queue.Update(positions[to], {distance[to], to});
+                    }
+                }
+            }
+            for (size_t i = 0; i < queue.Size(); ++i) {
+                assert(positions[queue.At(i).node] == i);
+            }
+        }
+
+        // Проверка против Дейкстры на std::priority_queue с ленивым удалением
+        std::vector<uint64_t> expected(num_nodes, std::numeric_limits<uint64_t>::max());
+        std::priority_queue<std::pair<uint64_t, size_t>, std::vector<std::pair<uint64_t, size_t>>, std::greater<>>
+            lazy;
+        expected[0] = 0;
+        lazy.emplace(0, 0);
+        while (!lazy.empty()) {
+            const auto [d, node] = lazy.top();
+            lazy.pop();
+            if (d != expected[node]) {
+                continue;
+            }
+            for (const auto& [to, weight] : graph[node]) {
+                if (d + weight < expected[to]) {
+                    expected[to] = d + weight;
+                    lazy.emplace(expected[to], to);
+                }
+            }
+        }
+        assert(distance == expected);
+
+        // Удаление из середины
+        for (size_t i = 0; i < 100; ++i) {
+            queue.Push({rng() % 1000, i});
+        }
+        queue.Erase(positions[42]);
+        queue.Erase(positions[7]);
+        assert(positions[42] == kNoHeapPosition && queue.Size() == 98);
+        uint64_t previous = 0;
+        while (!queue.Empty()) {
+            assert(queue.Top().distance >= previous && queue.Top().node != 42 && queue.Top().node != 7);
+            previous = queue.Top().distance;
+            queue.Pop();
+        }
+    }
+    {
+        Obj::ResetCounters();
+        {
+            Vector<Obj> source;
+            for (int i = 0; i < 10; ++i) {
+                source.EmplaceBack(i);
+            }
+            PriorityQueue<Obj, std::function<bool(const Obj&, const Obj&)>> queue([](const Obj& lhs, const Obj& rhs) {
+                return lhs.id < rhs.id;
+            });
+            queue.PushRange(source.begin(), source.end());
+            assert(queue.Top().id == 9);
+            // Ошибка копирования откатывает PushRange целиком
+            source[5].throw_on_copy = true;
+            try {
+                queue.PushRange(source.begin(), source.end());
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(queue.Size() == 10);
+            queue.Pop();
+            assert(queue.Top().id == 8);
+            queue.Clear();
+            assert(queue.Empty());
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
 struct C {
     C() noexcept {
         ++def_ctor;
@@ -640,6 +2296,594 @@ void Benchmark() {
     }
 }
 
+void BenchmarkGapVector() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t SIZE = 100'000;
+    const size_t NUM_EDITS = 20'000;
+    const size_t CURSOR = SIZE / 2;
+    {
+        Vector<int> v(SIZE);
+        const auto start = steady_clock::now();
+        for (size_t i = 0; i < NUM_EDITS; ++i) {
+            v.Insert(v.cbegin() + CURSOR + i % 16, static_cast<int>(i));
+        }
+        const auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        cerr << "Vector::Insert near cursor: "sv << elapsed.count() << " us"sv << endl;
+    }
+    {
+        GapVector<int> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.Insert(0);
+        }
+        const auto start = steady_clock::now();
+        for (size_t i = 0; i < NUM_EDITS; ++i) {
+            v.MoveCursor(CURSOR + i % 16);
+            v.Insert(static_cast<int>(i));
+        }
+        const auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        cerr << "GapVector::Insert near cursor: "sv << elapsed.count() << " us"sv << endl;
+    }
+}
+
+void BenchmarkFlatMap() {
+    using namespace std;
+    using namespace std::chrono;
+    const int SIZE = 100'000;
+    const int NUM_LOOKUPS = 1'000'000;
+    vector<pair<int, int>> items;
+    items.reserve(SIZE);
+    mt19937 generator(42);
+    for (int i = 0; i < SIZE; ++i) {
+        items.emplace_back(static_cast<int>(generator() % (SIZE * 4)), i);
+    }
+    FlatMap<int, int> flat_map;
+    flat_map.InsertRange(items.begin(), items.end());
+    map<int, int> std_map(items.begin(), items.end());
+
+    const auto time = [](const auto& name, const auto& func) {
+        const auto start = steady_clock::now();
+        const long long result = func();
+        const auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        cerr << name << ": "sv << elapsed.count() << " us (checksum "sv << result << ')' << endl;
+    };
+    time("FlatMap lookups"sv, [&] {
+        long long hits = 0;
+        for (int i = 0; i < NUM_LOOKUPS; ++i) {
+            hits += flat_map.Contains(i % (SIZE * 4));
+        }
+        return hits;
+    });
+    time("std::map lookups"sv, [&] {
+        long long hits = 0;
+        for (int i = 0; i < NUM_LOOKUPS; ++i) {
+            hits += std_map.count(i % (SIZE * 4));
+        }
+        return hits;
+    });
+    time("FlatMap iteration"sv, [&] {
+        long long sum = 0;
+        for (int repeat = 0; repeat < 10; ++repeat) {
+            for (const auto& [key, value] : flat_map) {
+                sum += value;
+            }
+        }
+        return sum;
+    });
+    time("std::map iteration"sv, [&] {
+        long long sum = 0;
+        for (int repeat = 0; repeat < 10; ++repeat) {
+            for (const auto& [key, value] : std_map) {
+                sum += value;
+            }
+        }
+        return sum;
+    });
+}
+
+void BenchmarkPackedIntVector() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t SIZE = 4'000'000;
+    mt19937_64 generator(42);
+    Vector<uint64_t> ids;
+    PackedIntVector packed_ids;
+    Vector<uint64_t> offsets;
+    SortedPackedIntVector sorted_offsets;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < SIZE; ++i) {
+        const uint64_t id = generator() % (1 << 20);
+        ids.PushBack(id);
+        packed_ids.PushBack(id);
+        offset += generator() % 4096;
+        offsets.PushBack(offset);
+        sorted_offsets.PushBack(offset);
+    }
+    cerr << "Vector<uint64_t> ids: "sv << ids.Capacity() * sizeof(uint64_t) << " bytes, PackedIntVector: "sv
+         << packed_ids.MemoryBytes() << " bytes ("sv << packed_ids.BitWidth() << " bits)"sv << endl;
+    cerr << "Vector<uint64_t> offsets: "sv << offsets.Capacity() * sizeof(uint64_t)
+         << " bytes, SortedPackedIntVector: "sv << sorted_offsets.MemoryBytes() << " bytes"sv << endl;
+
+    vector<uint64_t> buffer(SIZE);
+    const auto time = [&](const auto& name, const auto& decode) {
+        const auto start = steady_clock::now();
+        decode();
+        const auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        const uint64_t checksum = accumulate(buffer.begin(), buffer.end(), uint64_t{0});
+        cerr << name << " decode: "sv << elapsed.count() << " us, "sv
+             << SIZE / max<int64_t>(elapsed.count(), 1) << " M values/s (checksum "sv << checksum << ')' << endl;
+    };
+    time("Vector<uint64_t> ids"sv, [&] {
+        copy(ids.begin(), ids.end(), buffer.begin());
+    });
+    time("PackedIntVector"sv, [&] {
+        packed_ids.Decode(0, SIZE, buffer.data());
+    });
+    time("SortedPackedIntVector"sv, [&] {
+        sorted_offsets.Decode(0, SIZE, buffer.data());
+    });
+}
+
+void BenchmarkBufferCache() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t NUM_ITERATIONS = 100'000;
+    const size_t MAX_SIZE = 300;
+    const auto churn = [&] {
+        size_t checksum = 0;
+        for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+            Vector<int> v;
+            for (size_t j = 0, n = i % MAX_SIZE; j < n; ++j) {
+                v.PushBack(static_cast<int>(j));
+            }
+            checksum += v.Capacity();
+        }
+        return checksum;
+    };
+    const auto time = [&](bool enabled, unsigned num_threads) {
+        BufferCache::SetEnabled(enabled);
+        const auto start = steady_clock::now();
+        vector<thread> threads;
+        for (unsigned i = 0; i < num_threads; ++i) {
+            threads.emplace_back(churn);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        BufferCache::Trim();
+        BufferCache::SetEnabled(false);
+        return elapsed.count();
+    };
+    const unsigned max_threads = max(thread::hardware_concurrency(), 4u);
+    for (unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        cerr << "Vector churn, "sv << num_threads << " threads: operator new "sv << time(false, num_threads)
+             << " us, BufferCache "sv << time(true, num_threads) << " us"sv << endl;
+    }
+}
+
+void BenchmarkIncrementalVector() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t SIZE = 2'000'000;
+    const auto measure = [](const auto& name, auto& v) {
+        vector<int64_t> latencies(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            const auto start = steady_clock::now();
+            v.PushBack(to_string(i % 1000));
+            latencies[i] = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+        }
+        sort(latencies.begin(), latencies.end());
+        cerr << name << " PushBack latency, ns: p50 "sv << latencies[SIZE / 2] << ", p99 "sv
+             << latencies[SIZE * 99 / 100] << ", p999 "sv << latencies[SIZE * 999 / 1000] << ", max "sv
+             << latencies.back() << endl;
+    };
+    {
+        Vector<string> v;
+        measure("Vector"sv, v);
+    }
+    {
+        IncrementalVector<string> v;
+        measure("IncrementalVector"sv, v);
+    }
+}
+
+void BenchmarkRingVector() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t QUEUE_SIZE = 20'000;
+    const size_t NUM_OPERATIONS = 200'000;
+    const auto time = [&](auto& queue, auto pop_front) {
+        for (size_t i = 0; i < QUEUE_SIZE; ++i) {
+            queue.PushBack(static_cast<int>(i));
+        }
+        const auto start = steady_clock::now();
+        int64_t checksum = 0;
+        for (size_t i = 0; i < NUM_OPERATIONS; ++i) {
+            checksum += queue[0];
+            pop_front(queue);
+            queue.PushBack(static_cast<int>(i));
+        }
+        const auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        assert(checksum >= 0);
+        return elapsed.count();
+    };
+    Vector<int> vector_queue;
+    RingVector<int> ring_queue;
+    cerr << "FIFO of "sv << QUEUE_SIZE << " ints, "sv << NUM_OPERATIONS
+         << " pop/push pairs: Vector::Erase(begin()) "sv << time(vector_queue, [](auto& q) {
+                q.Erase(q.begin());
+            }) << " us, RingVector::PopFront "sv
+         << time(ring_queue, [](auto& q) {
+                q.PopFront();
+            }) << " us"sv << endl;
+}
+
+void BenchmarkParallelAlgorithms() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t SIZE = 20'000'000;
+    Vector<uint32_t> source(SIZE);
+    mt19937 rng(35);
+    for (auto& x : source) {
+        x = static_cast<uint32_t>(rng());
+    }
+    const auto time = [](auto&& f) {
+        const auto start = steady_clock::now();
+        f();
+        return duration_cast<milliseconds>(steady_clock::now() - start).count();
+    };
+    const unsigned max_threads = max(thread::hardware_concurrency(), 4u);
+    for (unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        ThreadPool pool(num_threads);
+        Vector<uint32_t> v(source);
+        Vector<uint64_t> out(SIZE);
+        uint64_t sum = 0;
+        const auto fill_ms = time([&] {
+            parallel::Fill(pool, out.begin(), out.end(), uint64_t{1});
+        });
+        const auto transform_ms = time([&] {
+            parallel::Transform(pool, v.begin(), v.end(), out.begin(), [](uint32_t x) {
+                return uint64_t{x} * x % 1'000'003;
+            });
+        });
+        const auto reduce_ms = time([&] {
+            sum = parallel::Reduce(pool, out.begin(), out.end(), uint64_t{0});
+        });
+        const auto sort_ms = time([&] {
+            parallel::Sort(pool, v.begin(), v.end());
+        });
+        assert(is_sorted(v.begin(), v.end()));
+        cerr << "Parallel algorithms over "sv << SIZE << " elements, "sv << num_threads << " threads: Fill "sv
+             << fill_ms << " ms, Transform "sv << transform_ms << " ms, Reduce "sv << reduce_ms << " ms, Sort "sv
+             << sort_ms << " ms (checksum "sv << sum << ')' << endl;
+    }
+}
+
+void BenchmarkDeferredDestruction() {
+#ifdef ADVANCED_VECTOR_DEFERRED_DESTRUCTION
+    using namespace std;
+    using namespace std::chrono;
+    const size_t SIZE = 2'000'000;
+    const auto time_destruction = [&] {
+        auto v = make_unique<Vector<string>>();
+        v->Reserve(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v->PushBack(string(40, static_cast<char>('a' + i % 26)));
+        }
+        const auto start = steady_clock::now();
+        v.reset();
+        return duration_cast<microseconds>(steady_clock::now() - start).count();
+    };
+    const auto sync_us = time_destruction();
+    DeferredDestruction::SetEnabled(true);
+    const auto deferred_us = time_destruction();
+    const auto drain_start = steady_clock::now();
+    DeferredDestruction::Drain();
+    const auto drain_us = duration_cast<microseconds>(steady_clock::now() - drain_start).count();
+    DeferredDestruction::SetEnabled(false);
+    cerr << "Destroying Vector of "sv << SIZE << " strings on the caller thread: synchronous "sv << sync_us
+         << " us, deferred "sv << deferred_us << " us (background drain "sv << drain_us << " us)"sv << endl;
+#endif
+}
+
+void BenchmarkCompactVector() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t NUM_VERTICES = 2'000'000;
+    const size_t NUM_EDGES = 1'000'000;
+    // header_bytes — заголовок в блоке каждого непустого внутреннего вектора
+    const auto build_and_scan = [&](auto& graph, size_t header_bytes) {
+        mt19937 rng(39);
+        const auto start = steady_clock::now();
+        for (size_t i = 0; i < NUM_EDGES; ++i) {
+            graph[rng() % NUM_VERTICES].PushBack(static_cast<int>(i));
+        }
+        int64_t checksum = 0;
+        for (const auto& edges : graph) {
+            checksum += static_cast<int64_t>(edges.Size());
+            for (int edge : edges) {
+                checksum += edge;
+            }
+        }
+        const auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        size_t bytes = graph.Capacity() * sizeof(graph[0]);
+        for (const auto& edges : graph) {
+            if (edges.Capacity() != 0) {
+                bytes += header_bytes + edges.Capacity() * sizeof(int);
+            }
+        }
+        return make_tuple(elapsed, bytes, checksum);
+    };
+    Vector<Vector<int>> nested(NUM_VERTICES);
+    const auto [nested_ms, nested_bytes, nested_checksum] = build_and_scan(nested, 0);
+    using Compact = CompactVector<int, uint32_t>;
+    Vector<Compact> compact(NUM_VERTICES);
+    const auto [compact_ms, compact_bytes, compact_checksum] = build_and_scan(compact, Compact::kHeaderBytes);
+    assert(nested_checksum == compact_checksum);
+    cerr << "Adjacency list of "sv << NUM_VERTICES << " vertices, "sv << NUM_EDGES << " edges: Vector<Vector<int>> "sv
+         << nested_ms << " ms, "sv << nested_bytes / 1024 << " KiB; Vector<CompactVector<int, uint32_t>> "sv
+         << compact_ms << " ms, "sv << compact_bytes / 1024 << " KiB (including block headers, allocator overhead excluded)"sv << endl;
+}
+
+void BenchmarkSlotMap() {
+    using namespace std;
+    using namespace std::chrono;
+    struct Particle {
+        double x = 0;
+        double y = 0;
+        double vx = 1;
+        double vy = 1;
+    };
+    const size_t SIZE = 1'000'000;
+    const size_t NUM_CHURN = 1'000'000;
+    const size_t NUM_PASSES = 10;
+    const auto time = [](auto&& f) {
+        const auto start = steady_clock::now();
+        f();
+        return duration_cast<milliseconds>(steady_clock::now() - start).count();
+    };
+    double checksum = 0;
+    {
+        SlotMap<Particle> map;
+        Vector<SlotMapHandle> handles;
+        mt19937 rng(40);
+        const auto insert_ms = time([&] {
+            for (size_t i = 0; i < SIZE; ++i) {
+                handles.PushBack(map.Emplace());
+            }
+        });
+        const auto churn_ms = time([&] {
+            for (size_t i = 0; i < NUM_CHURN; ++i) {
+                auto& handle = handles[rng() % SIZE];
+                map.Erase(handle);
+                handle = map.Emplace();
+            }
+        });
+        const auto iterate_ms = time([&] {
+            for (size_t pass = 0; pass < NUM_PASSES; ++pass) {
+                for (auto& p : map) {
+                    p.x += p.vx;
+                    p.y += p.vy;
+                }
+            }
+        });
+        const auto lookup_ms = time([&] {
+            for (size_t i = 0; i < NUM_CHURN; ++i) {
+                checksum += map.Get(handles[rng() % SIZE])->x;
+            }
+        });
+        cerr << "SlotMap of "sv << SIZE << " particles: insert "sv << insert_ms << " ms, churn "sv << churn_ms
+             << " ms, "sv << NUM_PASSES << " iteration passes "sv << iterate_ms << " ms, lookups "sv << lookup_ms
+             << " ms"sv << endl;
+    }
+    {
+        unordered_map<uint64_t, Particle> map;
+        Vector<uint64_t> ids;
+        uint64_t next_id = 0;
+        mt19937 rng(40);
+        const auto insert_ms = time([&] {
+            for (size_t i = 0; i < SIZE; ++i) {
+                map.emplace(next_id, Particle{});
+                ids.PushBack(next_id++);
+            }
+        });
+        const auto churn_ms = time([&] {
+            for (size_t i = 0; i < NUM_CHURN; ++i) {
+                auto& id = ids[rng() % SIZE];
+                map.erase(id);
+                map.emplace(next_id, Particle{});
+                id = next_id++;
+            }
+        });
+        const auto iterate_ms = time([&] {
+            for (size_t pass = 0; pass < NUM_PASSES; ++pass) {
+                for (auto& [id, p] : map) {
+                    p.x += p.vx;
+                    p.y += p.vy;
+                }
+            }
+        });
+        const auto lookup_ms = time([&] {
+            for (size_t i = 0; i < NUM_CHURN; ++i) {
+                checksum -= map.find(ids[rng() % SIZE])->second.x;
+            }
+        });
+        cerr << "unordered_map of "sv << SIZE << " particles: insert "sv << insert_ms << " ms, churn "sv << churn_ms
+             << " ms, "sv << NUM_PASSES << " iteration passes "sv << iterate_ms << " ms, lookups "sv << lookup_ms
+             << " ms (checksum "sv << checksum << ')' << endl;
+    }
+}
+
+void BenchmarkCapacityHints() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t NUM_VECTORS = 200'000;
+    mt19937 rng(41);
+    Vector<size_t> sizes;
+    for (size_t i = 0; i < NUM_VECTORS; ++i) {
+        sizes.PushBack(200 + rng() % 100);
+    }
+    const auto run = [&sizes](auto make) {
+        const auto start = steady_clock::now();
+        size_t total = 0;
+        for (const size_t size : sizes) {
+            auto v = make();
+            for (size_t i = 0; i < size; ++i) {
+                v.PushBack(i);
+            }
+            total += v.Size();
+        }
+        return pair{duration_cast<milliseconds>(steady_clock::now() - start).count(), total};
+    };
+    const auto [plain_ms, plain_total] = run([] {
+        return Vector<uint64_t>();
+    });
+    CapacityHints::SetEnabled(true);
+    const auto [hinted_ms, hinted_total] = run([] {
+        return HintedVector<uint64_t>(ADVANCED_VECTOR_HINT_SITE());
+    });
+    CapacityHints::SetEnabled(false);
+    assert(plain_total == hinted_total);
+    cerr << NUM_VECTORS << " vectors of 200-299 elements: Vector "sv << plain_ms << " ms, HintedVector "sv
+         << hinted_ms << " ms"sv << endl;
+}
+
+void BenchmarkMatrix() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t TRANSPOSE_SIZE = 2048;
+    const size_t MULTIPLY_SIZE = 512;
+    const auto time = [](auto&& f) {
+        const auto start = steady_clock::now();
+        f();
+        return duration_cast<milliseconds>(steady_clock::now() - start).count();
+    };
+    const auto make_nested = [](size_t n) {
+        Vector<Vector<double>> m(n);
+        for (size_t i = 0; i < n; ++i) {
+            m[i].Resize(n);
+            for (size_t j = 0; j < n; ++j) {
+                m[i][j] = static_cast<double>((i * 7 + j * 3) % 11);
+            }
+        }
+        return m;
+    };
+    const auto make_matrix = [](size_t n, MatrixLayout layout) {
+        Matrix<double> m(n, n, layout);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                m(i, j) = static_cast<double>((i * 7 + j * 3) % 11);
+            }
+        }
+        return m;
+    };
+
+    double checksum = 0;
+    {
+        const auto nested = make_nested(TRANSPOSE_SIZE);
+        const auto nested_ms = time([&] {
+            Vector<Vector<double>> t(TRANSPOSE_SIZE);
+            for (size_t i = 0; i < TRANSPOSE_SIZE; ++i) {
+                t[i].Resize(TRANSPOSE_SIZE);
+            }
+            for (size_t i = 0; i < TRANSPOSE_SIZE; ++i) {
+                for (size_t j = 0; j < TRANSPOSE_SIZE; ++j) {
+                    t[j][i] = nested[i][j];
+                }
+            }
+            checksum += t[1][2];
+        });
+        const auto row_major = make_matrix(TRANSPOSE_SIZE, MatrixLayout::kRowMajor);
+        const auto row_major_ms = time([&] {
+            checksum += row_major.Transposed()(1, 2);
+        });
+        const auto tiled = make_matrix(TRANSPOSE_SIZE, MatrixLayout::kTiled);
+        const auto tiled_ms = time([&] {
+            checksum += tiled.Transposed()(1, 2);
+        });
+        cerr << "Transpose "sv << TRANSPOSE_SIZE << 'x' << TRANSPOSE_SIZE << ": nested Vector "sv << nested_ms
+             << " ms, row-major Matrix "sv << row_major_ms << " ms, tiled Matrix "sv << tiled_ms << " ms"sv << endl;
+    }
+    {
+        const auto a = make_nested(MULTIPLY_SIZE);
+        const auto b = make_nested(MULTIPLY_SIZE);
+        const auto nested_ms = time([&] {
+            Vector<Vector<double>> c(MULTIPLY_SIZE);
+            for (size_t i = 0; i < MULTIPLY_SIZE; ++i) {
+                c[i].Resize(MULTIPLY_SIZE);
+                for (size_t k = 0; k < MULTIPLY_SIZE; ++k) {
+                    const double a_value = a[i][k];
+                    for (size_t j = 0; j < MULTIPLY_SIZE; ++j) {
+                        c[i][j] += a_value * b[k][j];
+                    }
+                }
+            }
+            checksum += c[1][2];
+        });
+        const auto row_major = make_matrix(MULTIPLY_SIZE, MatrixLayout::kRowMajor);
+        const auto row_major_ms = time([&] {
+            checksum += Multiply(row_major, row_major)(1, 2);
+        });
+        const auto tiled = make_matrix(MULTIPLY_SIZE, MatrixLayout::kTiled);
+        const auto tiled_ms = time([&] {
+            checksum += Multiply(tiled, tiled)(1, 2);
+        });
+        cerr << "Multiply "sv << MULTIPLY_SIZE << 'x' << MULTIPLY_SIZE << ": nested Vector "sv << nested_ms
+             << " ms, row-major Matrix "sv << row_major_ms << " ms, tiled Matrix "sv << tiled_ms << " ms (checksum "sv
+             << checksum << ')' << endl;
+    }
+}
+
+void BenchmarkPriorityQueue() {
+    using namespace std;
+    using namespace std::chrono;
+    const size_t NUM_OPERATIONS = 2'000'000;
+    const auto run = [](auto queue, size_t size) {
+        mt19937_64 rng(45);
+        const auto start = steady_clock::now();
+        uint64_t checksum = 0;
+        // Очередь заполняется до size элементов, затем работает в режиме
+        // «извлечь наименьший — добавить больший», как планировщик таймеров
+        for (size_t i = 0; i < size; ++i) {
+            queue.push(rng() % (size * 16));
+        }
+        for (size_t i = 0; i < NUM_OPERATIONS; ++i) {
+            const uint64_t top = queue.top();
+            checksum += top;
+            queue.pop();
+            queue.push(top + rng() % (size * 16));
+        }
+        return pair{duration_cast<milliseconds>(steady_clock::now() - start).count(), checksum};
+    };
+    // Обёртка с интерфейсом std::priority_queue
+    const auto make = [](auto arity) {
+        struct Adapter {
+            PriorityQueue<uint64_t, greater<uint64_t>, decltype(arity)::value> queue;
+            void push(uint64_t value) {
+                queue.Push(value);
+            }
+            void pop() {
+                queue.Pop();
+            }
+            uint64_t top() const {
+                return queue.Top();
+            }
+        };
+        return Adapter{};
+    };
+    for (const size_t size : {size_t{1'000}, size_t{100'000}, size_t{4'000'000}}) {
+        const auto [std_ms, std_sum] = run(priority_queue<uint64_t, std::vector<uint64_t>, greater<uint64_t>>(), size);
+        const auto [binary_ms, binary_sum] = run(make(integral_constant<size_t, 2>()), size);
+        const auto [quad_ms, quad_sum] = run(make(integral_constant<size_t, 4>()), size);
+        const auto [octo_ms, octo_sum] = run(make(integral_constant<size_t, 8>()), size);
+        assert(std_sum == binary_sum && std_sum == quad_sum && std_sum == octo_sum);
+        cerr << "Priority queue of "sv << size << ", "sv << NUM_OPERATIONS << " pop+push: std::priority_queue "sv
+             << std_ms << " ms, D=2 "sv << binary_ms << " ms, D=4 "sv << quad_ms << " ms, D=8 "sv << octo_ms << " ms"sv
+             << endl;
+    }
+}
+
 int main() {
     try {
         Test1();
@@ -648,7 +2892,37 @@ int main() {
         Test4();
         Test5();
         Test6();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
         Benchmark();
+        BenchmarkGapVector();
+        BenchmarkFlatMap();
+        BenchmarkPackedIntVector();
+        BenchmarkBufferCache();
+        BenchmarkIncrementalVector();
+        BenchmarkRingVector();
+        BenchmarkParallelAlgorithms();
+        BenchmarkDeferredDestruction();
+        BenchmarkCompactVector();
+        BenchmarkSlotMap();
+        BenchmarkCapacityHints();
+        BenchmarkMatrix();
+        BenchmarkPriorityQueue();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
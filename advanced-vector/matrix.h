@@ -0,0 +1,520 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "span.h"
+#include "vector.h"
+
+// Сторона квадратной плитки в элементах. Три плитки double занимают 24 КиБ и
+// помещаются в кэш L1 вместе
+inline constexpr size_t kMatrixTileSize = 32;
+
+enum class MatrixLayout {
+  // Строки лежат подряд одна за другой
+  kRowMajor,
+  // Матрица разбита на плитки kMatrixTileSize x kMatrixTileSize, каждая плитка
+  // хранится подряд по строкам, плитки идут по строкам. Размеры матрицы в
+  // памяти дополняются до кратных стороне плитки
+  kTiled,
+};
+
+// Строка или столбец матрицы. Элементы идут группами по kMatrixTileSize: с
+// шагом stride внутри группы и block_stride между началами групп. Так
+// описываются строки и столбцы обеих раскладок
+template <typename T>
+class MatrixLine {
+ public:
+  MatrixLine(T* data, size_t size, size_t stride, size_t block_stride) noexcept
+      : data_(data), size_(size), stride_(stride), block_stride_(block_stride) {}
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+  MatrixLine(MatrixLine<U> other) noexcept
+      : data_(other.data_),
+        size_(other.size_),
+        stride_(other.stride_),
+        block_stride_(other.block_stride_) {}
+
+  size_t Size() const noexcept { return size_; }
+
+  T& operator[](size_t index) const noexcept {
+    assert(index < size_);
+    return data_[index / kMatrixTileSize * block_stride_ +
+                 index % kMatrixTileSize * stride_];
+  }
+
+ private:
+  template <typename U>
+  friend class MatrixLine;
+
+  T* data_ = nullptr;
+  size_t size_ = 0;
+  size_t stride_ = 0;
+  size_t block_stride_ = 0;
+};
+
+// Прямоугольный участок матрицы, строки которого лежат подряд с шагом stride
+template <typename T>
+class MatrixView {
+ public:
+  MatrixView(T* data, size_t rows, size_t cols, size_t stride) noexcept
+      : data_(data), rows_(rows), cols_(cols), stride_(stride) {}
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+  MatrixView(MatrixView<U> other) noexcept
+      : data_(other.data_),
+        rows_(other.rows_),
+        cols_(other.cols_),
+        stride_(other.stride_) {}
+
+  size_t Rows() const noexcept { return rows_; }
+  size_t Cols() const noexcept { return cols_; }
+  size_t Stride() const noexcept { return stride_; }
+
+  T& operator()(size_t row, size_t col) const noexcept {
+    assert(row < rows_ && col < cols_);
+    return data_[row * stride_ + col];
+  }
+  Span<T> Row(size_t row) const noexcept {
+    assert(row < rows_);
+    return {data_ + row * stride_, cols_};
+  }
+
+ private:
+  template <typename U>
+  friend class MatrixView;
+
+  T* data_ = nullptr;
+  size_t rows_ = 0;
+  size_t cols_ = 0;
+  size_t stride_ = 0;
+};
+
+// Матрица в одном буфере RawMemory, выровненном по кэш-линии. Элементы
+// инициализируются значением по умолчанию, включая дополнение обеих
+// раскладок. Tile(i, j) даёт участок матрицы на месте плитки (i, j) в любой
+// раскладке, поэтому ядра транспонирования и умножения обходят матрицу
+// плитками независимо от раскладки; плиточная раскладка вдобавок хранит
+// каждую плитку подряд.
+template <typename T>
+class Matrix {
+ public:
+  static constexpr size_t kAlignment = std::max<size_t>(64, alignof(T));
+  static constexpr size_t kTileSize = kMatrixTileSize;
+
+  Matrix() = default;
+  Matrix(size_t rows, size_t cols,
+         MatrixLayout layout = MatrixLayout::kRowMajor);
+  Matrix(size_t rows, size_t cols, const T& value,
+         MatrixLayout layout = MatrixLayout::kRowMajor);
+  Matrix(const Matrix& other);
+  Matrix(Matrix&& other) noexcept;
+  Matrix& operator=(const Matrix& rhs);
+  Matrix& operator=(Matrix&& rhs) noexcept;
+  ~Matrix();
+
+  size_t Rows() const noexcept;
+  size_t Cols() const noexcept;
+  MatrixLayout Layout() const noexcept;
+
+  T& operator()(size_t row, size_t col) noexcept;
+  const T& operator()(size_t row, size_t col) const noexcept;
+  MatrixLine<T> Row(size_t row) noexcept;
+  MatrixLine<const T> Row(size_t row) const noexcept;
+  MatrixLine<T> Col(size_t col) noexcept;
+  MatrixLine<const T> Col(size_t col) const noexcept;
+
+  // Число плиток по вертикали и горизонтали; крайние плитки могут быть
+  // неполными
+  size_t TileRows() const noexcept;
+  size_t TileCols() const noexcept;
+  MatrixView<T> Tile(size_t tile_row, size_t tile_col) noexcept;
+  MatrixView<const T> Tile(size_t tile_row, size_t tile_col) const noexcept;
+
+  Matrix ToLayout(MatrixLayout layout) const;
+  // Транспонирование плитками в той же раскладке
+  Matrix Transposed() const;
+  void Swap(Matrix& other) noexcept;
+
+ private:
+  // Число элементов буфера; бросает std::length_error, если буфер не
+  // помещается в адресное пространство
+  static size_t StorageSize(size_t rows, size_t cols, MatrixLayout layout);
+  // Значение Stride() для матрицы с cols столбцами. Строку построчной
+  // раскладки длиной в кратное 512 байтам дополняет кэш-линия: иначе строки
+  // одной плитки попадают в одни и те же наборы кэша и вытесняют друг друга
+  static size_t LeadingDimension(size_t cols, MatrixLayout layout);
+  static T* Allocate(size_t n);
+  static void Deallocate(T* buffer, size_t capacity);
+
+  size_t Offset(size_t row, size_t col) const noexcept;
+  // Расстояние между соседними строками внутри плитки
+  size_t Stride() const noexcept;
+  // Конструирует значением по умолчанию элементы дополнения
+  void ConstructPadding() noexcept;
+
+  RawMemory<T> data_;
+  size_t rows_ = 0;
+  size_t cols_ = 0;
+  size_t stride_ = 0;
+  MatrixLayout layout_ = MatrixLayout::kRowMajor;
+};
+
+// Произведение матриц в раскладке lhs. Бросает std::invalid_argument, если
+// число столбцов lhs не равно числу строк rhs
+template <typename T>
+Matrix<T> Multiply(const Matrix<T>& lhs, const Matrix<T>& rhs);
+
+// Сравнивает размеры и элементы независимо от раскладки
+template <typename T>
+bool operator==(const Matrix<T>& lhs, const Matrix<T>& rhs);
+template <typename T>
+bool operator!=(const Matrix<T>& lhs, const Matrix<T>& rhs);
+
+template <typename T>
+Matrix<T>::Matrix(size_t rows, size_t cols, MatrixLayout layout)
+    : rows_(rows), cols_(cols),
+      stride_(LeadingDimension(cols, layout)),
+      layout_(layout) {
+  const size_t size = StorageSize(rows, cols, layout);
+  RawMemory<T> data(Allocate(size), size, &Deallocate);
+  std::uninitialized_value_construct_n(data.GetAddress(), size);
+  data_.Swap(data);
+}
+
+template <typename T>
+Matrix<T>::Matrix(size_t rows, size_t cols, const T& value, MatrixLayout layout)
+    : rows_(rows), cols_(cols),
+      stride_(LeadingDimension(cols, layout)),
+      layout_(layout) {
+  const size_t size = StorageSize(rows, cols, layout);
+  RawMemory<T> data(Allocate(size), size, &Deallocate);
+  std::uninitialized_fill_n(data.GetAddress(), size, value);
+  data_.Swap(data);
+}
+
+template <typename T>
+Matrix<T>::Matrix(const Matrix& other)
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      layout_(other.layout_) {
+  const size_t size = other.data_.Capacity();
+  RawMemory<T> data(Allocate(size), size, &Deallocate);
+  std::uninitialized_copy_n(other.data_.GetAddress(), size, data.GetAddress());
+  data_.Swap(data);
+}
+
+template <typename T>
+Matrix<T>::Matrix(Matrix&& other) noexcept {
+  Swap(other);
+}
+
+template <typename T>
+Matrix<T>& Matrix<T>::operator=(const Matrix& rhs) {
+  if (this != &rhs) {
+    Matrix copy(rhs);
+    Swap(copy);
+  }
+  return *this;
+}
+
+template <typename T>
+Matrix<T>& Matrix<T>::operator=(Matrix&& rhs) noexcept {
+  if (this != &rhs) {
+    Matrix moved(std::move(rhs));
+    Swap(moved);
+  }
+  return *this;
+}
+
+template <typename T>
+Matrix<T>::~Matrix() {
+  std::destroy_n(data_.GetAddress(), data_.Capacity());
+}
+
+template <typename T>
+size_t Matrix<T>::Rows() const noexcept {
+  return rows_;
+}
+
+template <typename T>
+size_t Matrix<T>::Cols() const noexcept {
+  return cols_;
+}
+
+template <typename T>
+MatrixLayout Matrix<T>::Layout() const noexcept {
+  return layout_;
+}
+
+template <typename T>
+T& Matrix<T>::operator()(size_t row, size_t col) noexcept {
+  assert(row < rows_ && col < cols_);
+  return data_[Offset(row, col)];
+}
+
+template <typename T>
+const T& Matrix<T>::operator()(size_t row, size_t col) const noexcept {
+  return const_cast<Matrix&>(*this)(row, col);
+}
+
+template <typename T>
+MatrixLine<T> Matrix<T>::Row(size_t row) noexcept {
+  assert(row < rows_);
+  if (cols_ == 0) {
+    return {nullptr, 0, 0, 0};
+  }
+  // Группа строки — её часть внутри одной плитки
+  const size_t block_stride =
+      layout_ == MatrixLayout::kTiled ? kTileSize * kTileSize : kTileSize;
+  return {data_ + Offset(row, 0), cols_, 1, block_stride};
+}
+
+template <typename T>
+MatrixLine<const T> Matrix<T>::Row(size_t row) const noexcept {
+  return const_cast<Matrix&>(*this).Row(row);
+}
+
+template <typename T>
+MatrixLine<T> Matrix<T>::Col(size_t col) noexcept {
+  assert(col < cols_);
+  if (rows_ == 0) {
+    return {nullptr, 0, 0, 0};
+  }
+  const size_t block_stride = layout_ == MatrixLayout::kTiled
+                                  ? TileCols() * kTileSize * kTileSize
+                                  : kTileSize * stride_;
+  return {data_ + Offset(0, col), rows_, Stride(), block_stride};
+}
+
+template <typename T>
+MatrixLine<const T> Matrix<T>::Col(size_t col) const noexcept {
+  return const_cast<Matrix&>(*this).Col(col);
+}
+
+template <typename T>
+size_t Matrix<T>::TileRows() const noexcept {
+  return (rows_ + kTileSize - 1) / kTileSize;
+}
+
+template <typename T>
+size_t Matrix<T>::TileCols() const noexcept {
+  return (cols_ + kTileSize - 1) / kTileSize;
+}
+
+template <typename T>
+MatrixView<T> Matrix<T>::Tile(size_t tile_row, size_t tile_col) noexcept {
+  assert(tile_row < TileRows() && tile_col < TileCols());
+  const size_t row = tile_row * kTileSize;
+  const size_t col = tile_col * kTileSize;
+  return {data_ + Offset(row, col), std::min(kTileSize, rows_ - row),
+          std::min(kTileSize, cols_ - col), Stride()};
+}
+
+template <typename T>
+MatrixView<const T> Matrix<T>::Tile(size_t tile_row,
+                                    size_t tile_col) const noexcept {
+  return const_cast<Matrix&>(*this).Tile(tile_row, tile_col);
+}
+
+template <typename T>
+Matrix<T> Matrix<T>::ToLayout(MatrixLayout layout) const {
+  if (layout == layout_) {
+    return *this;
+  }
+  Matrix result(rows_, cols_, layout);
+  // Сетка плиток у обеих раскладок одна и та же
+  for (size_t i = 0; i < TileRows(); ++i) {
+    for (size_t j = 0; j < TileCols(); ++j) {
+      const MatrixView<const T> src = Tile(i, j);
+      const MatrixView<T> dst = result.Tile(i, j);
+      for (size_t row = 0; row < src.Rows(); ++row) {
+        std::copy_n(&src(row, 0), src.Cols(), &dst(row, 0));
+      }
+    }
+  }
+  return result;
+}
+
+template <typename T>
+Matrix<T> Matrix<T>::Transposed() const {
+  if constexpr (std::is_nothrow_copy_constructible_v<T> &&
+                std::is_nothrow_default_constructible_v<T>) {
+    // Как и конструктор копирования, строит элементы сразу на месте, без
+    // предварительной инициализации всего буфера
+    Matrix result;
+    const size_t size = StorageSize(cols_, rows_, layout_);
+    RawMemory<T> data(Allocate(size), size, &Deallocate);
+    result.data_.Swap(data);
+    result.rows_ = cols_;
+    result.cols_ = rows_;
+    result.stride_ = LeadingDimension(rows_, layout_);
+    result.layout_ = layout_;
+    for (size_t i = 0; i < TileRows(); ++i) {
+      for (size_t j = 0; j < TileCols(); ++j) {
+        const MatrixView<const T> src = Tile(i, j);
+        const MatrixView<T> dst = result.Tile(j, i);
+        // Запись идёт подряд по строкам результата, чтение — столбцами
+        // плитки, которая целиком остаётся в кэше
+        for (size_t col = 0; col < src.Cols(); ++col) {
+          for (size_t row = 0; row < src.Rows(); ++row) {
+            new (&dst(col, row)) T(src(row, col));
+          }
+        }
+      }
+    }
+    result.ConstructPadding();
+    return result;
+  } else {
+    Matrix result(cols_, rows_, layout_);
+    for (size_t i = 0; i < TileRows(); ++i) {
+      for (size_t j = 0; j < TileCols(); ++j) {
+        const MatrixView<const T> src = Tile(i, j);
+        const MatrixView<T> dst = result.Tile(j, i);
+        for (size_t col = 0; col < src.Cols(); ++col) {
+          for (size_t row = 0; row < src.Rows(); ++row) {
+            dst(col, row) = src(row, col);
+          }
+        }
+      }
+    }
+    return result;
+  }
+}
+
+template <typename T>
+void Matrix<T>::Swap(Matrix& other) noexcept {
+  data_.Swap(other.data_);
+  std::swap(rows_, other.rows_);
+  std::swap(cols_, other.cols_);
+  std::swap(stride_, other.stride_);
+  std::swap(layout_, other.layout_);
+}
+
+template <typename T>
+size_t Matrix<T>::StorageSize(size_t rows, size_t cols, MatrixLayout layout) {
+  constexpr size_t kMax = std::numeric_limits<size_t>::max() / sizeof(T);
+  if (layout == MatrixLayout::kTiled) {
+    if (rows > kMax - kTileSize) {
+      throw std::length_error("Matrix is too large");
+    }
+    rows = (rows + kTileSize - 1) / kTileSize * kTileSize;
+  }
+  cols = LeadingDimension(cols, layout);
+  if (cols != 0 && rows > kMax / cols) {
+    throw std::length_error("Matrix is too large");
+  }
+  return rows * cols;
+}
+
+template <typename T>
+size_t Matrix<T>::LeadingDimension(size_t cols, MatrixLayout layout) {
+  constexpr size_t kMax = std::numeric_limits<size_t>::max() / sizeof(T);
+  constexpr size_t kLinePadding = (kAlignment + sizeof(T) - 1) / sizeof(T);
+  if (cols > kMax - std::max(kTileSize, kLinePadding)) {
+    throw std::length_error("Matrix is too large");
+  }
+  if (layout == MatrixLayout::kTiled) {
+    return (cols + kTileSize - 1) / kTileSize * kTileSize;
+  }
+  return cols != 0 && cols * sizeof(T) % 512 == 0 ? cols + kLinePadding
+                                                   : cols;
+}
+
+template <typename T>
+T* Matrix<T>::Allocate(size_t n) {
+  return n != 0 ? static_cast<T*>(::operator new(
+                      n * sizeof(T), std::align_val_t{kAlignment}))
+                : nullptr;
+}
+
+template <typename T>
+void Matrix<T>::Deallocate(T* buffer, size_t) {
+  ::operator delete(buffer, std::align_val_t{kAlignment});
+}
+
+template <typename T>
+size_t Matrix<T>::Offset(size_t row, size_t col) const noexcept {
+  if (layout_ == MatrixLayout::kRowMajor) {
+    return row * stride_ + col;
+  }
+  const size_t tile = row / kTileSize * TileCols() + col / kTileSize;
+  return tile * kTileSize * kTileSize + row % kTileSize * kTileSize +
+         col % kTileSize;
+}
+
+template <typename T>
+size_t Matrix<T>::Stride() const noexcept {
+  return layout_ == MatrixLayout::kTiled ? kTileSize : stride_;
+}
+
+template <typename T>
+void Matrix<T>::ConstructPadding() noexcept {
+  // Построчная раскладка дополнена только справа, плиточная — ещё и снизу
+  const size_t padded_rows =
+      layout_ == MatrixLayout::kTiled ? TileRows() * kTileSize : rows_;
+  const size_t padded_cols =
+      layout_ == MatrixLayout::kTiled ? TileCols() * kTileSize : stride_;
+  for (size_t row = 0; row < padded_rows; ++row) {
+    for (size_t col = row < rows_ ? cols_ : 0; col < padded_cols; ++col) {
+      new (data_ + Offset(row, col)) T();
+    }
+  }
+}
+
+template <typename T>
+Matrix<T> Multiply(const Matrix<T>& lhs, const Matrix<T>& rhs) {
+  if (lhs.Cols() != rhs.Rows()) {
+    throw std::invalid_argument("Matrix dimensions do not match");
+  }
+  Matrix<T> result(lhs.Rows(), rhs.Cols(), lhs.Layout());
+  // Три плитки, участвующие во внутреннем цикле, одновременно лежат в кэше;
+  // самый внутренний цикл идёт подряд по строкам плиток rhs и результата
+  for (size_t i = 0; i < lhs.TileRows(); ++i) {
+    for (size_t k = 0; k < lhs.TileCols(); ++k) {
+      const MatrixView<const T> a = lhs.Tile(i, k);
+      for (size_t j = 0; j < rhs.TileCols(); ++j) {
+        const MatrixView<const T> b = rhs.Tile(k, j);
+        const MatrixView<T> c = result.Tile(i, j);
+        for (size_t row = 0; row < a.Rows(); ++row) {
+          T* c_row = &c(row, 0);
+          for (size_t kk = 0; kk < a.Cols(); ++kk) {
+            const T a_value = a(row, kk);
+            const T* b_row = &b(kk, 0);
+            for (size_t col = 0; col < b.Cols(); ++col) {
+              c_row[col] += a_value * b_row[col];
+            }
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+template <typename T>
+bool operator==(const Matrix<T>& lhs, const Matrix<T>& rhs) {
+  if (lhs.Rows() != rhs.Rows() || lhs.Cols() != rhs.Cols()) {
+    return false;
+  }
+  for (size_t row = 0; row < lhs.Rows(); ++row) {
+    for (size_t col = 0; col < lhs.Cols(); ++col) {
+      if (!(lhs(row, col) == rhs(row, col))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool operator!=(const Matrix<T>& lhs, const Matrix<T>& rhs) {
+  return !(lhs == rhs);
+}
@@ -0,0 +1,313 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+
+#include "vector.h"
+
+namespace packed_int_detail {
+
+inline constexpr size_t kWordBits = 64;
+
+inline size_t WordsFor(size_t bits) noexcept {
+  return (bits + kWordBits - 1) / kWordBits;
+}
+
+inline unsigned BitWidth(uint64_t value) noexcept {
+  return value == 0 ? 0 : kWordBits - __builtin_clzll(value);
+}
+
+inline uint64_t Mask(unsigned width) noexcept {
+  return width == kWordBits ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+}
+
+// Читает значение с номером index. За последним используемым словом должно
+// быть ещё одно, тогда чтение обходится без ветвлений по смещению: при
+// off == 0 сдвиг старшего слова на 64 разбит на два и даёт ноль. Проверка
+// нулевой разрядности не зависит от index и выносится компилятором из циклов
+inline uint64_t Read(const uint64_t* words, size_t index,
+                     unsigned width) noexcept {
+  if (width == 0) {
+    return 0;
+  }
+  const size_t bit = index * width;
+  const size_t word = bit / kWordBits;
+  const unsigned off = bit % kWordBits;
+  const uint64_t lo = words[word] >> off;
+  const uint64_t hi = (words[word + 1] << 1) << (kWordBits - 1 - off);
+  return (lo | hi) & Mask(width);
+}
+
+// Записывает значение в обнулённые биты
+inline void Write(uint64_t* words, size_t index, unsigned width,
+                  uint64_t value) noexcept {
+  if (width == 0) {
+    return;
+  }
+  const size_t bit = index * width;
+  const size_t word = bit / kWordBits;
+  const unsigned off = bit % kWordBits;
+  words[word] |= value << off;
+  if (off + width > kWordBits) {
+    words[word + 1] |= value >> (kWordBits - off);
+  }
+}
+
+// Итератор по значениям контейнера, обращающийся к нему по индексу
+template <typename Container>
+class ValueIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = uint64_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = uint64_t;
+
+  ValueIterator() = default;
+  ValueIterator(const Container* container, size_t index) noexcept
+      : container_(container), index_(index) {}
+
+  uint64_t operator*() const noexcept { return (*container_)[index_]; }
+  ValueIterator& operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+  ValueIterator operator++(int) noexcept {
+    auto old = *this;
+    ++index_;
+    return old;
+  }
+  bool operator==(const ValueIterator& rhs) const noexcept {
+    return container_ == rhs.container_ && index_ == rhs.index_;
+  }
+  bool operator!=(const ValueIterator& rhs) const noexcept {
+    return !(*this == rhs);
+  }
+
+ private:
+  const Container* container_ = nullptr;
+  size_t index_ = 0;
+};
+
+}  // namespace packed_int_detail
+
+// Вектор беззнаковых целых, упакованных с фиксированной разрядностью.
+// Разрядность определяется наибольшим добавленным значением: PushBack
+// большего значения перепаковывает контейнер, что в сумме стоит не более 64
+// перепаковок за время жизни.
+class PackedIntVector {
+ public:
+  using const_iterator = packed_int_detail::ValueIterator<PackedIntVector>;
+
+  PackedIntVector() = default;
+  explicit PackedIntVector(unsigned bit_width);
+
+  size_t Size() const noexcept;
+  unsigned BitWidth() const noexcept;
+  // Объём памяти, занимаемой упакованными данными
+  size_t MemoryBytes() const noexcept;
+  uint64_t operator[](size_t index) const noexcept;
+  void Reserve(size_t new_capacity);
+  void PushBack(uint64_t value);
+  // Распаковывает count значений, начиная с first, в out
+  void Decode(size_t first, size_t count, uint64_t* out) const noexcept;
+
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+
+ private:
+  void Repack(unsigned new_width);
+
+  // Упакованные значения и одно дополнительное слово для чтения без ветвлений
+  Vector<uint64_t> words_;
+  size_t size_ = 0;
+  unsigned width_ = 0;
+};
+
+// Вектор неубывающей последовательности беззнаковых целых. Значения разбиты
+// на блоки по kBlockSize, каждый блок хранит опорное значение (первый элемент)
+// и смещения от него с разрядностью, достаточной для этого блока, поэтому
+// произвольный доступ стоит O(1). Последний неполный блок хранится без сжатия.
+class SortedPackedIntVector {
+ public:
+  using const_iterator =
+      packed_int_detail::ValueIterator<SortedPackedIntVector>;
+
+  static constexpr size_t kBlockSize = 128;
+
+  size_t Size() const noexcept;
+  size_t MemoryBytes() const noexcept;
+  uint64_t operator[](size_t index) const noexcept;
+  // Значение не должно быть меньше последнего добавленного
+  void PushBack(uint64_t value);
+  void Decode(size_t first, size_t count, uint64_t* out) const noexcept;
+
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+
+ private:
+  struct Block {
+    uint64_t anchor = 0;
+    size_t word_offset = 0;
+    unsigned width = 0;
+  };
+
+  void SealTail();
+
+  Vector<Block> blocks_;
+  // Блок из kBlockSize значений разрядности w занимает ровно 2 * w слов,
+  // поэтому каждый блок начинается с границы слова
+  Vector<uint64_t> words_;
+  std::array<uint64_t, kBlockSize> tail_{};
+  size_t tail_size_ = 0;
+};
+
+inline PackedIntVector::PackedIntVector(unsigned bit_width) : width_(bit_width) {
+  assert(bit_width <= packed_int_detail::kWordBits);
+}
+
+inline size_t PackedIntVector::Size() const noexcept {
+  return size_;
+}
+
+inline unsigned PackedIntVector::BitWidth() const noexcept {
+  return width_;
+}
+
+inline size_t PackedIntVector::MemoryBytes() const noexcept {
+  return words_.Capacity() * sizeof(uint64_t);
+}
+
+inline uint64_t PackedIntVector::operator[](size_t index) const noexcept {
+  assert(index < size_);
+  return packed_int_detail::Read(words_.begin(), index, width_);
+}
+
+inline void PackedIntVector::Reserve(size_t new_capacity) {
+  words_.Reserve(packed_int_detail::WordsFor(new_capacity * width_) + 1);
+}
+
+inline void PackedIntVector::PushBack(uint64_t value) {
+  using namespace packed_int_detail;
+  const unsigned value_width = packed_int_detail::BitWidth(value);
+  if (value_width > width_) {
+    Repack(value_width);
+  }
+  // Vector::Resize растёт геометрически и заполняет новые слова нулями
+  words_.Resize(WordsFor((size_ + 1) * width_) + 1);
+  Write(words_.begin(), size_, width_, value);
+  ++size_;
+}
+
+inline void PackedIntVector::Decode(size_t first, size_t count,
+                                    uint64_t* out) const noexcept {
+  assert(first + count <= size_);
+  const uint64_t* words = words_.begin();
+  const unsigned width = width_;
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = packed_int_detail::Read(words, first + i, width);
+  }
+}
+
+inline PackedIntVector::const_iterator PackedIntVector::begin() const noexcept {
+  return {this, 0};
+}
+
+inline PackedIntVector::const_iterator PackedIntVector::end() const noexcept {
+  return {this, size_};
+}
+
+inline void PackedIntVector::Repack(unsigned new_width) {
+  using namespace packed_int_detail;
+  Vector<uint64_t> new_words(WordsFor(size_ * new_width) + 1);
+  for (size_t i = 0; i < size_; ++i) {
+    Write(new_words.begin(), i, new_width, (*this)[i]);
+  }
+  words_.Swap(new_words);
+  width_ = new_width;
+}
+
+inline size_t SortedPackedIntVector::Size() const noexcept {
+  return blocks_.Size() * kBlockSize + tail_size_;
+}
+
+inline size_t SortedPackedIntVector::MemoryBytes() const noexcept {
+  return blocks_.Capacity() * sizeof(Block) +
+         words_.Capacity() * sizeof(uint64_t) + sizeof(tail_);
+}
+
+inline uint64_t SortedPackedIntVector::operator[](
+    size_t index) const noexcept {
+  assert(index < Size());
+  const size_t block_index = index / kBlockSize;
+  if (block_index == blocks_.Size()) {
+    return tail_[index % kBlockSize];
+  }
+  const Block& block = blocks_[block_index];
+  return block.anchor + packed_int_detail::Read(words_.begin() + block.word_offset,
+                                                index % kBlockSize, block.width);
+}
+
+inline void SortedPackedIntVector::PushBack(uint64_t value) {
+  assert(Size() == 0 || value >= (*this)[Size() - 1]);
+  tail_[tail_size_++] = value;
+  if (tail_size_ == kBlockSize) {
+    SealTail();
+  }
+}
+
+inline void SortedPackedIntVector::Decode(size_t first, size_t count,
+                                          uint64_t* out) const noexcept {
+  assert(first + count <= Size());
+  while (count != 0) {
+    const size_t block_index = first / kBlockSize;
+    const size_t offset = first % kBlockSize;
+    const size_t n = std::min(count, kBlockSize - offset);
+    if (block_index == blocks_.Size()) {
+      std::copy_n(tail_.begin() + offset, n, out);
+    } else {
+      const Block& block = blocks_[block_index];
+      const uint64_t* words = words_.begin() + block.word_offset;
+      for (size_t i = 0; i < n; ++i) {
+        out[i] = block.anchor +
+                 packed_int_detail::Read(words, offset + i, block.width);
+      }
+    }
+    first += n;
+    count -= n;
+    out += n;
+  }
+}
+
+inline SortedPackedIntVector::const_iterator SortedPackedIntVector::begin()
+    const noexcept {
+  return {this, 0};
+}
+
+inline SortedPackedIntVector::const_iterator SortedPackedIntVector::end()
+    const noexcept {
+  return {this, Size()};
+}
+
+inline void SortedPackedIntVector::SealTail() {
+  using namespace packed_int_detail;
+  Block block;
+  block.anchor = tail_[0];
+  block.width = packed_int_detail::BitWidth(tail_[kBlockSize - 1] - block.anchor);
+  // Первое слово блока совпадает с дополнительным словом предыдущего
+  block.word_offset = words_.Size() == 0 ? 0 : words_.Size() - 1;
+  blocks_.PushBack(block);
+  try {
+    words_.Resize(block.word_offset + 2 * block.width + 1);
+  } catch (...) {
+    blocks_.PopBack();
+    throw;
+  }
+  for (size_t i = 0; i < kBlockSize; ++i) {
+    Write(words_.begin() + block.word_offset, i, block.width,
+          tail_[i] - block.anchor);
+  }
+  tail_size_ = 0;
+}
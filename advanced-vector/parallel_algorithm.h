@@ -0,0 +1,238 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+#include "thread_pool.h"
+#include "vector.h"
+
+// Параллельные алгоритмы над диапазонами с произвольным доступом (в первую
+// очередь итераторами Vector). Диапазон делится на куски, помещающиеся в
+// кэш второго уровня; куски раздаются рекурсивным делением пополам, так что
+// свободные потоки крадут крупные половины, а не отдельные куски. Диапазоны
+// не длиннее kSerialCutoffChunks кусков и пулы с параллелизмом 1
+// обрабатываются последовательно в вызывающем потоке.
+//
+// Функции, переданные в алгоритмы, вызываются одновременно из разных потоков.
+// Исключение из любой из них перебрасывается вызывающему после завершения
+// остальных кусков; часть диапазона к этому моменту может быть обработана.
+namespace parallel {
+
+inline constexpr size_t kChunkBytes = size_t{64} << 10;
+inline constexpr size_t kSerialCutoffChunks = 4;
+
+ThreadPool& DefaultThreadPool();
+
+template <typename RandomIt, typename F>
+void ForEach(ThreadPool& pool, RandomIt first, RandomIt last, F f);
+template <typename RandomIt, typename F>
+void ForEach(RandomIt first, RandomIt last, F f);
+
+// Выход без произвольного доступа (например, std::back_inserter) заполняется
+// последовательно в вызывающем потоке
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt Transform(ThreadPool& pool, RandomIt first, RandomIt last,
+                   OutputIt d_first, UnaryOp op);
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt Transform(RandomIt first, RandomIt last, OutputIt d_first,
+                   UnaryOp op);
+
+template <typename RandomIt, typename T>
+void Fill(ThreadPool& pool, RandomIt first, RandomIt last, const T& value);
+template <typename RandomIt, typename T>
+void Fill(RandomIt first, RandomIt last, const T& value);
+
+// Операция должна быть ассоциативной; частичные суммы кусков объединяются
+// слева направо, поэтому коммутативность не требуется
+template <typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+T Reduce(ThreadPool& pool, RandomIt first, RandomIt last, T init,
+         BinaryOp op = {});
+template <typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+T Reduce(RandomIt first, RandomIt last, T init, BinaryOp op = {});
+
+// Неустойчивая сортировка: куски сортируются параллельно, затем сливаются
+// попарно раундами, в каждом из которых пары сливаются параллельно
+template <typename RandomIt, typename Compare = std::less<>>
+void Sort(ThreadPool& pool, RandomIt first, RandomIt last, Compare comp = {});
+template <typename RandomIt, typename Compare = std::less<>>
+void Sort(RandomIt first, RandomIt last, Compare comp = {});
+
+}  // namespace parallel
+
+namespace parallel_detail {
+
+template <typename... Ts>
+constexpr size_t ChunkSize() noexcept {
+  return std::max<size_t>(1, parallel::kChunkBytes / std::max({sizeof(Ts)...}));
+}
+
+inline bool IsSerial(const ThreadPool& pool, size_t n, size_t chunk) noexcept {
+  return pool.Concurrency() == 1 || n <= chunk * parallel::kSerialCutoffChunks;
+}
+
+// Вызывает body(begin, end) для кусков [0, n) длиной chunk (последний может
+// быть короче). Правая половина отдаётся в пул, левая делится дальше на месте
+template <typename Body>
+void SplitChunks(TaskGroup& group, size_t begin, size_t end, size_t chunk,
+                 const Body& body) {
+  while (end - begin > chunk) {
+    const size_t half = ((end - begin) / chunk + 1) / 2 * chunk;
+    const size_t mid = begin + half;
+    group.Run([&group, mid, end, chunk, &body] {
+      SplitChunks(group, mid, end, chunk, body);
+    });
+    end = mid;
+  }
+  body(begin, end);
+}
+
+template <typename Body>
+void ForChunks(ThreadPool& pool, size_t n, size_t chunk, const Body& body) {
+  if (n == 0) {
+    return;
+  }
+  // Если body бросит исключение в этом потоке, деструктор группы дождётся
+  // уже отданных кусков, которые ссылаются на body
+  TaskGroup group(pool);
+  SplitChunks(group, 0, n, chunk, body);
+  group.Wait();
+}
+
+}  // namespace parallel_detail
+
+namespace parallel {
+
+inline ThreadPool& DefaultThreadPool() {
+  static ThreadPool pool;
+  return pool;
+}
+
+template <typename RandomIt, typename F>
+void ForEach(ThreadPool& pool, RandomIt first, RandomIt last, F f) {
+  using Value = typename std::iterator_traits<RandomIt>::value_type;
+  const size_t n = last - first;
+  const size_t chunk = parallel_detail::ChunkSize<Value>();
+  if (parallel_detail::IsSerial(pool, n, chunk)) {
+    std::for_each(first, last, f);
+    return;
+  }
+  parallel_detail::ForChunks(pool, n, chunk, [first, &f](size_t begin, size_t end) {
+    std::for_each(first + begin, first + end, f);
+  });
+}
+
+template <typename RandomIt, typename F>
+void ForEach(RandomIt first, RandomIt last, F f) {
+  ForEach(DefaultThreadPool(), first, last, std::move(f));
+}
+
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt Transform(ThreadPool& pool, RandomIt first, RandomIt last,
+                   OutputIt d_first, UnaryOp op) {
+  using Value = typename std::iterator_traits<RandomIt>::value_type;
+  using Result = std::decay_t<std::invoke_result_t<UnaryOp&, decltype(*first)>>;
+  using OutputCategory =
+      typename std::iterator_traits<OutputIt>::iterator_category;
+  const size_t n = last - first;
+  const size_t chunk = parallel_detail::ChunkSize<Value, Result>();
+  if constexpr (!std::is_base_of_v<std::random_access_iterator_tag,
+                                   OutputCategory>) {
+    return std::transform(first, last, d_first, op);
+  } else {
+    if (parallel_detail::IsSerial(pool, n, chunk)) {
+      return std::transform(first, last, d_first, op);
+    }
+    parallel_detail::ForChunks(
+        pool, n, chunk, [first, d_first, &op](size_t begin, size_t end) {
+          std::transform(first + begin, first + end, d_first + begin, op);
+        });
+    return d_first + n;
+  }
+}
+
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt Transform(RandomIt first, RandomIt last, OutputIt d_first,
+                   UnaryOp op) {
+  return Transform(DefaultThreadPool(), first, last, d_first, std::move(op));
+}
+
+template <typename RandomIt, typename T>
+void Fill(ThreadPool& pool, RandomIt first, RandomIt last, const T& value) {
+  using Value = typename std::iterator_traits<RandomIt>::value_type;
+  const size_t n = last - first;
+  const size_t chunk = parallel_detail::ChunkSize<Value>();
+  if (parallel_detail::IsSerial(pool, n, chunk)) {
+    std::fill(first, last, value);
+    return;
+  }
+  parallel_detail::ForChunks(pool, n, chunk, [first, &value](size_t begin, size_t end) {
+    std::fill(first + begin, first + end, value);
+  });
+}
+
+template <typename RandomIt, typename T>
+void Fill(RandomIt first, RandomIt last, const T& value) {
+  Fill(DefaultThreadPool(), first, last, value);
+}
+
+template <typename RandomIt, typename T, typename BinaryOp>
+T Reduce(ThreadPool& pool, RandomIt first, RandomIt last, T init,
+         BinaryOp op) {
+  using Value = typename std::iterator_traits<RandomIt>::value_type;
+  const size_t n = last - first;
+  const size_t chunk = parallel_detail::ChunkSize<Value>();
+  if (parallel_detail::IsSerial(pool, n, chunk)) {
+    return std::accumulate(first, last, std::move(init), op);
+  }
+  // Частичная сумма куска начинается с его первого элемента, поэтому T не
+  // обязан иметь нейтральный элемент, но должен конструироваться по умолчанию
+  Vector<T> partials((n + chunk - 1) / chunk);
+  parallel_detail::ForChunks(
+      pool, n, chunk, [first, chunk, &partials, &op](size_t begin, size_t end) {
+        partials[begin / chunk] =
+            std::accumulate(first + begin + 1, first + end, T(first[begin]), op);
+      });
+  return std::accumulate(std::make_move_iterator(partials.begin()),
+                         std::make_move_iterator(partials.end()),
+                         std::move(init), op);
+}
+
+template <typename RandomIt, typename T, typename BinaryOp>
+T Reduce(RandomIt first, RandomIt last, T init, BinaryOp op) {
+  return Reduce(DefaultThreadPool(), first, last, std::move(init),
+                std::move(op));
+}
+
+template <typename RandomIt, typename Compare>
+void Sort(ThreadPool& pool, RandomIt first, RandomIt last, Compare comp) {
+  using Value = typename std::iterator_traits<RandomIt>::value_type;
+  const size_t n = last - first;
+  const size_t chunk = parallel_detail::ChunkSize<Value>();
+  if (parallel_detail::IsSerial(pool, n, chunk)) {
+    std::sort(first, last, comp);
+    return;
+  }
+  parallel_detail::ForChunks(pool, n, chunk, [first, &comp](size_t begin, size_t end) {
+    std::sort(first + begin, first + end, comp);
+  });
+  for (size_t width = chunk; width < n; width *= 2) {
+    const size_t num_pairs = (n + 2 * width - 1) / (2 * width);
+    parallel_detail::ForChunks(
+        pool, num_pairs, 1, [first, n, width, &comp](size_t pair, size_t) {
+          const size_t lo = pair * 2 * width;
+          const size_t mid = std::min(lo + width, n);
+          const size_t hi = std::min(lo + 2 * width, n);
+          std::inplace_merge(first + lo, first + mid, first + hi, comp);
+        });
+  }
+}
+
+template <typename RandomIt, typename Compare>
+void Sort(RandomIt first, RandomIt last, Compare comp) {
+  Sort(DefaultThreadPool(), first, last, std::move(comp));
+}
+
+}  // namespace parallel
@@ -0,0 +1,402 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Позиция элемента, которого нет в очереди
+inline constexpr size_t kNoHeapPosition = std::numeric_limits<size_t>::max();
+
+// Индекс позиций по умолчанию: позиции не отслеживаются
+struct NoHeapPositionIndex {
+  template <typename T>
+  void operator()(const T&, size_t) const noexcept {}
+};
+
+// Очередь с приоритетами на D-арной куче поверх Vector. Как и в
+// std::priority_queue, Top возвращает наибольший по Compare элемент. Дети
+// узла i лежат подряд на позициях D * i + 1 ... D * i + D. Буфер кучи выровнен
+// по кэш-линии, а перед корнем оставлено D - 1 пустых мест, поэтому группа
+// детей начинается в буфере с позиции, кратной D. Если D * sizeof(T) равно
+// размеру кэш-линии (D = 8 для uint64_t) или делит его, каждая группа
+// целиком лежит в одной кэш-линии. Высота кучи при этом меньше, чем у
+// двоичной.
+//
+// PositionIndex вызывается как index(element, position) каждый раз, когда
+// элемент занимает позицию в куче, и с kNoHeapPosition, когда он покидает
+// очередь. Сохранив позиции, например в поле задачи или в таблице по её
+// номеру, можно менять приоритет элемента через Update и удалять его через
+// Erase за O(log n).
+//
+// Если сравнение или перемещение элементов бросает исключение, очередь
+// остаётся в согласованном, но неопределённом состоянии; PushRange даёт
+// строгую гарантию, если исключение бросает копирование.
+template <typename T, typename Compare = std::less<T>, size_t D = 4,
+          typename PositionIndex = NoHeapPositionIndex>
+class PriorityQueue {
+  static_assert(D >= 2, "Heap arity must be at least 2");
+
+ public:
+  PriorityQueue() = default;
+  explicit PriorityQueue(const Compare& compare,
+                         const PositionIndex& index = PositionIndex());
+  PriorityQueue(const PriorityQueue& other);
+  PriorityQueue(PriorityQueue&&) = default;
+  PriorityQueue& operator=(const PriorityQueue& rhs);
+  PriorityQueue& operator=(PriorityQueue&&) = default;
+
+  size_t Size() const noexcept;
+  bool Empty() const noexcept;
+  void Reserve(size_t new_capacity);
+  void Clear() noexcept;
+
+  const T& Top() const noexcept;
+  // Элемент на позиции, сообщённой PositionIndex
+  const T& At(size_t position) const noexcept;
+
+  void Push(const T& value);
+  void Push(T&& value);
+  template <typename... Args>
+  void Emplace(Args&&... args);
+  // Добавляет диапазон. Если он не меньше текущей очереди, куча
+  // перестраивается целиком за O(n), иначе элементы просеиваются по одному
+  template <typename InputIt>
+  void PushRange(InputIt first, InputIt last);
+  void Pop();
+
+  // Заменяет элемент на позиции position и восстанавливает кучу
+  void Update(size_t position, T value);
+  void Erase(size_t position);
+
+ private:
+  static constexpr size_t kCacheLine = 64;
+  static constexpr size_t kAlignment = std::max(kCacheLine, alignof(T));
+  // Пустые места перед корнем, выравнивающие группы детей
+  static constexpr size_t kPadding = D - 1;
+
+  // Буфер кучи выделяется и растёт только здесь: Vector перевыделил бы
+  // память без выравнивания и пустых мест
+  static T* Allocate(size_t capacity);
+  static void Deallocate(T* data, size_t capacity);
+  void Grow();
+  // Медленный путь Emplace, вынесенный, чтобы не мешать встраиванию
+  // быстрого
+  template <typename... Args>
+  void GrowAndEmplaceBack(Args&&... args);
+
+  // Помещают value в дырку hole и перемещают её вверх или вниз
+  void SiftUp(size_t hole, T value);
+  void SiftDown(size_t hole, T value);
+  // Опускает дырку до листа по лучшим детям, не сравнивая их с value, и
+  // поднимает value оттуда. Последний элемент кучи, которым заполняется
+  // дырка при удалении, обычно возвращается почти до листа, поэтому так
+  // выходит меньше сравнений и непредсказуемых ветвлений
+  void SiftDownToLeaf(size_t hole, T value);
+  void Restore(size_t hole, T value);
+  void MakeHeap();
+  // Лучший из детей, начиная с first_child; у полной группы из D детей
+  // цикл имеет постоянную длину и разворачивается компилятором
+  size_t BestChild(size_t first_child);
+  void Place(size_t position, T&& value);
+
+  Vector<T> heap_;
+  Compare compare_;
+  PositionIndex index_;
+};
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+PriorityQueue<T, Compare, D, PositionIndex>::PriorityQueue(
+    const Compare& compare, const PositionIndex& index)
+    : compare_(compare), index_(index) {}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+PriorityQueue<T, Compare, D, PositionIndex>::PriorityQueue(
+    const PriorityQueue& other)
+    : compare_(other.compare_), index_(other.index_) {
+  Reserve(other.Size());
+  for (const T& value : other.heap_) {
+    heap_.EmplaceBack(value);
+  }
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+PriorityQueue<T, Compare, D, PositionIndex>&
+PriorityQueue<T, Compare, D, PositionIndex>::operator=(
+    const PriorityQueue& rhs) {
+  if (this != &rhs) {
+    *this = PriorityQueue(rhs);
+  }
+  return *this;
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+size_t PriorityQueue<T, Compare, D, PositionIndex>::Size() const noexcept {
+  return heap_.Size();
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+bool PriorityQueue<T, Compare, D, PositionIndex>::Empty() const noexcept {
+  return heap_.Size() == 0;
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Reserve(size_t new_capacity) {
+  if (new_capacity <= heap_.Capacity()) {
+    return;
+  }
+  T* data = Allocate(new_capacity);
+  try {
+    vector_detail::UninitMoveOrCopy(heap_.begin(), heap_.end(), data);
+  } catch (...) {
+    Deallocate(data, new_capacity);
+    throw;
+  }
+  // Старые элементы разрушаются вместе с прежним буфером
+  heap_ = Vector<T>::Adopt(data, heap_.Size(), new_capacity, &Deallocate);
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Clear() noexcept {
+  for (const T& value : heap_) {
+    index_(value, kNoHeapPosition);
+  }
+  heap_.Clear();
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+const T& PriorityQueue<T, Compare, D, PositionIndex>::Top() const noexcept {
+  assert(!Empty());
+  return heap_[0];
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+const T& PriorityQueue<T, Compare, D, PositionIndex>::At(
+    size_t position) const noexcept {
+  assert(position < heap_.Size());
+  return heap_[position];
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Push(const T& value) {
+  Emplace(value);
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Push(T&& value) {
+  Emplace(std::move(value));
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+template <typename... Args>
+void PriorityQueue<T, Compare, D, PositionIndex>::Emplace(Args&&... args) {
+  if (heap_.Size() == heap_.Capacity()) {
+    GrowAndEmplaceBack(std::forward<Args>(args)...);
+  } else {
+    heap_.EmplaceBack(std::forward<Args>(args)...);
+  }
+  T& back = heap_.begin()[heap_.Size() - 1];
+  SiftUp(heap_.Size() - 1, std::move(back));
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+template <typename InputIt>
+void PriorityQueue<T, Compare, D, PositionIndex>::PushRange(InputIt first,
+                                                            InputIt last) {
+  const size_t old_size = heap_.Size();
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                  typename std::iterator_traits<
+                                      InputIt>::iterator_category>) {
+    heap_.Reserve(old_size + std::distance(first, last));
+  }
+  try {
+    for (; first != last; ++first) {
+      if (heap_.Size() == heap_.Capacity()) {
+        Grow();
+      }
+      heap_.EmplaceBack(*first);
+    }
+  } catch (...) {
+    while (heap_.Size() > old_size) {
+      heap_.PopBack();
+    }
+    throw;
+  }
+  if (heap_.Size() - old_size >= old_size) {
+    MakeHeap();
+  } else {
+    for (size_t i = old_size; i < heap_.Size(); ++i) {
+      SiftUp(i, std::move(heap_[i]));
+    }
+  }
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Pop() {
+  Erase(0);
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Update(size_t position,
+                                                         T value) {
+  assert(position < heap_.Size());
+  Restore(position, std::move(value));
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Erase(size_t position) {
+  assert(position < heap_.Size());
+  index_(heap_[position], kNoHeapPosition);
+  const size_t last = heap_.Size() - 1;
+  if (position == last) {
+    heap_.PopBack();
+    return;
+  }
+  T value = std::move(heap_[last]);
+  heap_.PopBack();
+  if (position > 0 && compare_(heap_[(position - 1) / D], value)) {
+    SiftUp(position, std::move(value));
+  } else {
+    SiftDownToLeaf(position, std::move(value));
+  }
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+T* PriorityQueue<T, Compare, D, PositionIndex>::Allocate(size_t capacity) {
+  if (capacity > std::numeric_limits<size_t>::max() / sizeof(T) - kPadding) {
+    throw std::length_error("PriorityQueue capacity is too large");
+  }
+  return static_cast<T*>(::operator new((capacity + kPadding) * sizeof(T),
+                                        std::align_val_t{kAlignment})) +
+         kPadding;
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Deallocate(T* data, size_t) {
+  ::operator delete(data - kPadding, std::align_val_t{kAlignment});
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Grow() {
+  // Первый буфер вмещает корень и полную группу его детей
+  Reserve(heap_.Size() == 0 ? D + 1 : heap_.Size() * 2);
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+template <typename... Args>
+void PriorityQueue<T, Compare, D, PositionIndex>::GrowAndEmplaceBack(
+    Args&&... args) {
+  // Аргументы могут ссылаться на элементы очереди, поэтому элемент создаётся
+  // до переноса
+  T value(std::forward<Args>(args)...);
+  Grow();
+  heap_.EmplaceBack(std::move(value));
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::SiftUp(size_t hole, T value) {
+  while (hole > 0) {
+    const size_t parent = (hole - 1) / D;
+    if (!compare_(heap_.begin()[parent], value)) {
+      break;
+    }
+    Place(hole, std::move(heap_.begin()[parent]));
+    hole = parent;
+  }
+  Place(hole, std::move(value));
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::SiftDown(size_t hole,
+                                                           T value) {
+  const size_t size = heap_.Size();
+  while (true) {
+    const size_t first_child = hole * D + 1;
+    if (first_child >= size) {
+      break;
+    }
+    const size_t best = BestChild(first_child);
+    if (!compare_(value, heap_.begin()[best])) {
+      break;
+    }
+    Place(hole, std::move(heap_.begin()[best]));
+    hole = best;
+  }
+  Place(hole, std::move(value));
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::SiftDownToLeaf(size_t hole,
+                                                                 T value) {
+  const size_t size = heap_.Size();
+  while (true) {
+    const size_t first_child = hole * D + 1;
+    if (first_child >= size) {
+      break;
+    }
+    const size_t best = BestChild(first_child);
+    Place(hole, std::move(heap_.begin()[best]));
+    hole = best;
+  }
+  // Выше исходной дырки value не поднимется: её родитель не меньше value
+  SiftUp(hole, std::move(value));
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Restore(size_t hole,
+                                                          T value) {
+  if (hole > 0 && compare_(heap_[(hole - 1) / D], value)) {
+    SiftUp(hole, std::move(value));
+  } else {
+    SiftDown(hole, std::move(value));
+  }
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::MakeHeap() {
+  const size_t size = heap_.Size();
+  // Листья не просеиваются, поэтому их позиции сообщаются отдельно
+  const size_t first_leaf = size < 2 ? 0 : (size - 2) / D + 1;
+  for (size_t i = first_leaf; i < size; ++i) {
+    index_(heap_[i], i);
+  }
+  for (size_t i = first_leaf; i-- > 0;) {
+    SiftDown(i, std::move(heap_[i]));
+  }
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+size_t PriorityQueue<T, Compare, D, PositionIndex>::BestChild(
+    size_t first_child) {
+  const T* heap = heap_.begin();
+  size_t best = first_child;
+  if (first_child + D <= heap_.Size()) {
+    for (size_t i = 1; i < D; ++i) {
+      if (compare_(heap[best], heap[first_child + i])) {
+        best = first_child + i;
+      }
+    }
+  } else {
+    for (size_t child = first_child + 1; child < heap_.Size(); ++child) {
+      if (compare_(heap[best], heap[child])) {
+        best = child;
+      }
+    }
+  }
+  return best;
+}
+
+template <typename T, typename Compare, size_t D, typename PositionIndex>
+void PriorityQueue<T, Compare, D, PositionIndex>::Place(size_t position,
+                                                        T&& value) {
+  T& slot = heap_.begin()[position];
+  slot = std::move(value);
+  index_(slot, position);
+}
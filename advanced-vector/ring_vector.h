@@ -0,0 +1,275 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "vector.h"
+
+// Кольцевой буфер поверх RawMemory. Добавление и удаление с обоих концов
+// выполняются за амортизированное O(1). Элементы занимают не более двух
+// непрерывных участков буфера: [head_, capacity) и [0, остаток).
+template <typename T>
+class RingVector {
+ public:
+  struct Span {
+    T* data = nullptr;
+    size_t size = 0;
+  };
+  struct ConstSpan {
+    const T* data = nullptr;
+    size_t size = 0;
+  };
+
+  RingVector() = default;
+  RingVector(const RingVector& other);
+  RingVector(RingVector&& other) noexcept;
+  RingVector& operator=(const RingVector& rhs);
+  RingVector& operator=(RingVector&& rhs) noexcept;
+  ~RingVector();
+
+  size_t Size() const noexcept;
+  size_t Capacity() const noexcept;
+  T& operator[](size_t index) noexcept;
+  const T& operator[](size_t index) const noexcept;
+  T& Front() noexcept;
+  T& Back() noexcept;
+  void Reserve(size_t new_capacity);
+  void PushBack(const T& value);
+  void PushBack(T&& value);
+  template <typename... Args>
+  T& EmplaceBack(Args&&... args);
+  void PushFront(const T& value);
+  void PushFront(T&& value);
+  template <typename... Args>
+  T& EmplaceFront(Args&&... args);
+  void PopBack() noexcept;
+  void PopFront() noexcept;
+  void Clear() noexcept;
+  void Swap(RingVector& other) noexcept;
+
+  // Элементы по порядку как два непрерывных участка; второй пуст, если
+  // элементы не переходят через конец буфера
+  std::pair<Span, Span> Spans() noexcept;
+  std::pair<ConstSpan, ConstSpan> Spans() const noexcept;
+
+ private:
+  size_t Physical(size_t index) const noexcept;
+  // Переносит элементы в начало нового буфера со сдвигом offset
+  void Reallocate(RawMemory<T>& new_data, size_t offset);
+
+  RawMemory<T> data_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+template <typename T>
+RingVector<T>::RingVector(const RingVector& other)
+    : data_{other.size_}, size_{other.size_} {
+  const auto [first, second] = other.Spans();
+  std::uninitialized_copy_n(first.data, first.size, data_.GetAddress());
+  try {
+    std::uninitialized_copy_n(second.data, second.size, data_ + first.size);
+  } catch (...) {
+    std::destroy_n(data_.GetAddress(), first.size);
+    throw;
+  }
+}
+
+template <typename T>
+RingVector<T>::RingVector(RingVector&& other) noexcept {
+  Swap(other);
+}
+
+template <typename T>
+RingVector<T>& RingVector<T>::operator=(const RingVector& rhs) {
+  if (this != &rhs) {
+    RingVector rhs_copy(rhs);
+    Swap(rhs_copy);
+  }
+  return *this;
+}
+
+template <typename T>
+RingVector<T>& RingVector<T>::operator=(RingVector&& rhs) noexcept {
+  if (this != &rhs) {
+    Swap(rhs);
+  }
+  return *this;
+}
+
+template <typename T>
+RingVector<T>::~RingVector() {
+  Clear();
+}
+
+template <typename T>
+size_t RingVector<T>::Size() const noexcept {
+  return size_;
+}
+
+template <typename T>
+size_t RingVector<T>::Capacity() const noexcept {
+  return data_.Capacity();
+}
+
+template <typename T>
+const T& RingVector<T>::operator[](size_t index) const noexcept {
+  return const_cast<RingVector&>(*this)[index];
+}
+
+template <typename T>
+T& RingVector<T>::operator[](size_t index) noexcept {
+  assert(index < size_);
+  return data_[Physical(index)];
+}
+
+template <typename T>
+T& RingVector<T>::Front() noexcept {
+  return (*this)[0];
+}
+
+template <typename T>
+T& RingVector<T>::Back() noexcept {
+  return (*this)[size_ - 1];
+}
+
+template <typename T>
+void RingVector<T>::Reserve(size_t new_capacity) {
+  if (new_capacity <= data_.Capacity()) {
+    return;
+  }
+  RawMemory<T> new_data{new_capacity};
+  Reallocate(new_data, 0);
+}
+
+template <typename T>
+void RingVector<T>::PushBack(const T& value) {
+  EmplaceBack(value);
+}
+
+template <typename T>
+void RingVector<T>::PushBack(T&& value) {
+  EmplaceBack(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+T& RingVector<T>::EmplaceBack(Args&&... args) {
+  if (size_ == data_.Capacity()) {
+    RawMemory<T> new_data{size_ == 0 ? 1 : size_ * 2};
+    new (new_data + size_) T(std::forward<Args>(args)...);
+    try {
+      Reallocate(new_data, 0);
+    } catch (...) {
+      std::destroy_at(new_data + size_);
+      throw;
+    }
+  } else {
+    new (data_ + Physical(size_)) T(std::forward<Args>(args)...);
+  }
+  ++size_;
+  return Back();
+}
+
+template <typename T>
+void RingVector<T>::PushFront(const T& value) {
+  EmplaceFront(value);
+}
+
+template <typename T>
+void RingVector<T>::PushFront(T&& value) {
+  EmplaceFront(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+T& RingVector<T>::EmplaceFront(Args&&... args) {
+  if (size_ == data_.Capacity()) {
+    RawMemory<T> new_data{size_ == 0 ? 1 : size_ * 2};
+    new (new_data + 0) T(std::forward<Args>(args)...);
+    try {
+      Reallocate(new_data, 1);
+    } catch (...) {
+      std::destroy_at(new_data + 0);
+      throw;
+    }
+  } else {
+    const size_t new_head = head_ == 0 ? data_.Capacity() - 1 : head_ - 1;
+    new (data_ + new_head) T(std::forward<Args>(args)...);
+    head_ = new_head;
+  }
+  ++size_;
+  return Front();
+}
+
+template <typename T>
+void RingVector<T>::PopBack() noexcept {
+  assert(size_ != 0);
+  std::destroy_at(&Back());
+  --size_;
+}
+
+template <typename T>
+void RingVector<T>::PopFront() noexcept {
+  assert(size_ != 0);
+  std::destroy_at(&Front());
+  head_ = head_ + 1 == data_.Capacity() ? 0 : head_ + 1;
+  --size_;
+}
+
+template <typename T>
+void RingVector<T>::Clear() noexcept {
+  const auto [first, second] = Spans();
+  std::destroy_n(first.data, first.size);
+  std::destroy_n(second.data, second.size);
+  head_ = 0;
+  size_ = 0;
+}
+
+template <typename T>
+void RingVector<T>::Swap(RingVector& other) noexcept {
+  data_.Swap(other.data_);
+  std::swap(head_, other.head_);
+  std::swap(size_, other.size_);
+}
+
+template <typename T>
+std::pair<typename RingVector<T>::Span, typename RingVector<T>::Span>
+RingVector<T>::Spans() noexcept {
+  const size_t first_size = std::min(size_, data_.Capacity() - head_);
+  return {{data_.GetAddress() + head_, first_size},
+          {data_.GetAddress(), size_ - first_size}};
+}
+
+template <typename T>
+std::pair<typename RingVector<T>::ConstSpan, typename RingVector<T>::ConstSpan>
+RingVector<T>::Spans() const noexcept {
+  const auto [first, second] = const_cast<RingVector&>(*this).Spans();
+  return {{first.data, first.size}, {second.data, second.size}};
+}
+
+template <typename T>
+size_t RingVector<T>::Physical(size_t index) const noexcept {
+  const size_t tail_room = data_.Capacity() - head_;
+  return index < tail_room ? head_ + index : index - tail_room;
+}
+
+template <typename T>
+void RingVector<T>::Reallocate(RawMemory<T>& new_data, size_t offset) {
+  const auto [first, second] = Spans();
+  vector_detail::UninitMoveOrCopy(first.data, first.data + first.size,
+                                  new_data + offset);
+  try {
+    vector_detail::UninitMoveOrCopy(second.data, second.data + second.size,
+                                    new_data + offset + first.size);
+  } catch (...) {
+    std::destroy_n(new_data + offset, first.size);
+    throw;
+  }
+  std::destroy_n(first.data, first.size);
+  std::destroy_n(second.data, second.size);
+  data_.Swap(new_data);
+  head_ = 0;
+}
@@ -0,0 +1,207 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "vector.h"
+
+// Устойчивый идентификатор элемента SlotMap: номер ячейки таблицы косвенности
+// и её поколение на момент вставки
+struct SlotMapHandle {
+  uint32_t index = std::numeric_limits<uint32_t>::max();
+  uint32_t generation = 0;
+
+  bool operator==(const SlotMapHandle& rhs) const noexcept {
+    return index == rhs.index && generation == rhs.generation;
+  }
+  bool operator!=(const SlotMapHandle& rhs) const noexcept {
+    return !(*this == rhs);
+  }
+};
+
+// Контейнер с устойчивыми идентификаторами и плотным хранением. Элементы
+// лежат подряд в Vector, поэтому обход идёт по непрерывной памяти, а удаление
+// переносит последний элемент на место удалённого. Идентификатор указывает
+// на ячейку таблицы косвенности, которая хранит текущую позицию элемента и
+// поколение; при удалении поколение ячейки увеличивается, и старые
+// идентификаторы перестают находить элемент. Свободные ячейки связаны в
+// список и переиспользуются. Поколение 32-битное, поэтому устаревший
+// идентификатор может снова стать действительным только после 2^32
+// переиспользований одной ячейки.
+template <typename T>
+class SlotMap {
+ public:
+  using Handle = SlotMapHandle;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  size_t Size() const noexcept;
+  void Reserve(size_t new_capacity);
+
+  Handle Insert(const T& value);
+  Handle Insert(T&& value);
+  template <typename... Args>
+  Handle Emplace(Args&&... args);
+  // Возвращает false, если идентификатор устарел
+  bool Erase(Handle handle);
+  void Clear() noexcept;
+
+  bool Contains(Handle handle) const noexcept;
+  // nullptr, если идентификатор устарел
+  T* Get(Handle handle) noexcept;
+  const T* Get(Handle handle) const noexcept;
+  // Идентификатор элемента, стоящего на позиции index при обходе
+  Handle HandleAt(size_t index) const noexcept;
+
+  // Порядок обхода меняется при удалении
+  iterator begin() noexcept;
+  iterator end() noexcept;
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+
+ private:
+  static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+
+  struct Slot {
+    // Позиция элемента в values_ либо следующая свободная ячейка
+    uint32_t index = kNoSlot;
+    uint32_t generation = 0;
+  };
+
+  Vector<T> values_;
+  // Ячейка, на которую ссылается элемент values_[i]
+  Vector<uint32_t> value_slots_;
+  Vector<Slot> slots_;
+  uint32_t free_head_ = kNoSlot;
+};
+
+template <typename T>
+size_t SlotMap<T>::Size() const noexcept {
+  return values_.Size();
+}
+
+template <typename T>
+void SlotMap<T>::Reserve(size_t new_capacity) {
+  values_.Reserve(new_capacity);
+  value_slots_.Reserve(new_capacity);
+  slots_.Reserve(new_capacity);
+}
+
+template <typename T>
+SlotMapHandle SlotMap<T>::Insert(const T& value) {
+  return Emplace(value);
+}
+
+template <typename T>
+SlotMapHandle SlotMap<T>::Insert(T&& value) {
+  return Emplace(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+SlotMapHandle SlotMap<T>::Emplace(Args&&... args) {
+  assert(values_.Size() < kNoSlot);
+  values_.EmplaceBack(std::forward<Args>(args)...);
+  const uint32_t slot_index =
+      free_head_ != kNoSlot ? free_head_ : static_cast<uint32_t>(slots_.Size());
+  try {
+    value_slots_.PushBack(slot_index);
+    if (slot_index == slots_.Size()) {
+      try {
+        slots_.PushBack(Slot{});
+      } catch (...) {
+        value_slots_.PopBack();
+        throw;
+      }
+    }
+  } catch (...) {
+    values_.PopBack();
+    throw;
+  }
+  Slot& slot = slots_[slot_index];
+  if (slot_index == free_head_) {
+    free_head_ = slot.index;
+  }
+  slot.index = static_cast<uint32_t>(values_.Size() - 1);
+  return {slot_index, slot.generation};
+}
+
+template <typename T>
+bool SlotMap<T>::Erase(Handle handle) {
+  if (!Contains(handle)) {
+    return false;
+  }
+  Slot& slot = slots_[handle.index];
+  const uint32_t index = slot.index;
+  const uint32_t last = static_cast<uint32_t>(values_.Size() - 1);
+  if (index != last) {
+    values_[index] = std::move(values_[last]);
+    value_slots_[index] = value_slots_[last];
+    slots_[value_slots_[index]].index = index;
+  }
+  values_.PopBack();
+  value_slots_.PopBack();
+  ++slot.generation;
+  slot.index = free_head_;
+  free_head_ = handle.index;
+  return true;
+}
+
+template <typename T>
+void SlotMap<T>::Clear() noexcept {
+  // Все занятые ячейки освобождаются, чтобы их идентификаторы устарели
+  for (const uint32_t slot_index : value_slots_) {
+    Slot& slot = slots_[slot_index];
+    ++slot.generation;
+    slot.index = free_head_;
+    free_head_ = slot_index;
+  }
+  values_.Clear();
+  value_slots_.Clear();
+}
+
+template <typename T>
+bool SlotMap<T>::Contains(Handle handle) const noexcept {
+  // Поколение свободной ячейки увеличено при удалении и ещё не выдавалось,
+  // поэтому совпадение поколений означает, что ячейка занята
+  return handle.index < slots_.Size() &&
+         slots_[handle.index].generation == handle.generation;
+}
+
+template <typename T>
+T* SlotMap<T>::Get(Handle handle) noexcept {
+  return Contains(handle) ? &values_[slots_[handle.index].index] : nullptr;
+}
+
+template <typename T>
+const T* SlotMap<T>::Get(Handle handle) const noexcept {
+  return const_cast<SlotMap&>(*this).Get(handle);
+}
+
+template <typename T>
+SlotMapHandle SlotMap<T>::HandleAt(size_t index) const noexcept {
+  assert(index < values_.Size());
+  const uint32_t slot_index = value_slots_[index];
+  return {slot_index, slots_[slot_index].generation};
+}
+
+template <typename T>
+typename SlotMap<T>::iterator SlotMap<T>::begin() noexcept {
+  return values_.begin();
+}
+
+template <typename T>
+typename SlotMap<T>::iterator SlotMap<T>::end() noexcept {
+  return values_.end();
+}
+
+template <typename T>
+typename SlotMap<T>::const_iterator SlotMap<T>::begin() const noexcept {
+  return values_.begin();
+}
+
+template <typename T>
+typename SlotMap<T>::const_iterator SlotMap<T>::end() const noexcept {
+  return values_.end();
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cassert>
+#include <type_traits>
+
+#include "vector.h"
+
+// Невладеющее представление непрерывного диапазона элементов. Не продлевает
+// жизнь данных и становится недействительным при перевыделении памяти
+// вектора, из которого получено. Span<const T> получается неявно из Span<T>
+// и из константного Vector.
+template <typename T>
+class Span {
+ public:
+  using iterator = T*;
+
+  Span() = default;
+  Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+  Span(Span<U> other) noexcept : data_(other.Data()), size_(other.Size()) {}
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+  Span(Vector<U>& vector) noexcept : data_(vector.begin()), size_(vector.Size()) {}
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible_v<const U (*)[], T (*)[]>>>
+  Span(const Vector<U>& vector) noexcept
+      : data_(vector.begin()), size_(vector.Size()) {}
+
+  T* Data() const noexcept { return data_; }
+  size_t Size() const noexcept { return size_; }
+  size_t SizeBytes() const noexcept { return size_ * sizeof(T); }
+  bool Empty() const noexcept { return size_ == 0; }
+
+  T& operator[](size_t index) const noexcept {
+    assert(index < size_);
+    return data_[index];
+  }
+  T& Front() const noexcept { return (*this)[0]; }
+  T& Back() const noexcept { return (*this)[size_ - 1]; }
+
+  // Срез из count элементов начиная с offset
+  Span Subspan(size_t offset, size_t count) const noexcept {
+    assert(offset <= size_ && count <= size_ - offset);
+    return {data_ + offset, count};
+  }
+  // Срез от offset до конца
+  Span Subspan(size_t offset) const noexcept {
+    assert(offset <= size_);
+    return {data_ + offset, size_ - offset};
+  }
+  Span First(size_t count) const noexcept { return Subspan(0, count); }
+  Span Last(size_t count) const noexcept {
+    assert(count <= size_);
+    return Subspan(size_ - count, count);
+  }
+
+  iterator begin() const noexcept { return data_; }
+  iterator end() const noexcept { return data_ + size_; }
+
+ private:
+  T* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+template <typename T>
+Span(Vector<T>&) -> Span<T>;
+template <typename T>
+Span(const Vector<T>&) -> Span<const T>;
+
+// Срез вектора [offset, offset + count)
+template <typename T>
+Span<T> Slice(Vector<T>& vector, size_t offset, size_t count) noexcept {
+  return Span<T>(vector).Subspan(offset, count);
+}
+
+template <typename T>
+Span<const T> Slice(const Vector<T>& vector, size_t offset,
+                    size_t count) noexcept {
+  return Span<const T>(vector).Subspan(offset, count);
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "vector.h"
+
+// Кольцевой буфер фиксированной ёмкости для передачи элементов из одного
+// потока-производителя в один поток-потребитель без блокировок. TryPush и
+// TryEmplace вызывает только производитель, TryPop — только потребитель.
+//
+// Счётчики head_ и tail_ только растут, а позиция в буфере берётся по маске,
+// поэтому ёмкость округляется вверх до степени двойки. Каждая сторона держит
+// закэшированное значение чужого счётчика и перечитывает атомарную
+// переменную, только когда кэш говорит, что буфер полон (пуст); счётчики
+// разнесены по разным строкам кэша, чтобы стороны не мешали друг другу.
+template <typename T>
+class SpscRing {
+ public:
+  explicit SpscRing(size_t capacity);
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+  ~SpscRing();
+
+  size_t Capacity() const noexcept;
+  // Приблизительный размер: точен, только если другая сторона неактивна
+  size_t SizeApprox() const noexcept;
+
+  bool TryPush(const T& value);
+  bool TryPush(T&& value);
+  // Возвращает false, не создавая элемент, если буфер полон
+  template <typename... Args>
+  bool TryEmplace(Args&&... args);
+  // Перемещает первый элемент в value; возвращает false, если буфер пуст
+  bool TryPop(T& value);
+
+ private:
+  static constexpr size_t kCacheLine = 64;
+
+  static size_t RoundUpToPowerOfTwo(size_t n) noexcept;
+
+  RawMemory<T> data_;
+  size_t mask_;
+
+  // Поля потребителя
+  alignas(kCacheLine) std::atomic<size_t> head_{0};
+  size_t cached_tail_ = 0;
+
+  // Поля производителя
+  alignas(kCacheLine) std::atomic<size_t> tail_{0};
+  size_t cached_head_ = 0;
+};
+
+template <typename T>
+SpscRing<T>::SpscRing(size_t capacity)
+    : data_{RoundUpToPowerOfTwo(capacity)}, mask_{data_.Capacity() - 1} {
+  assert(capacity != 0);
+}
+
+template <typename T>
+SpscRing<T>::~SpscRing() {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+    std::destroy_at(data_ + (i & mask_));
+  }
+}
+
+template <typename T>
+size_t SpscRing<T>::Capacity() const noexcept {
+  return data_.Capacity();
+}
+
+template <typename T>
+size_t SpscRing<T>::SizeApprox() const noexcept {
+  const size_t head = head_.load(std::memory_order_acquire);
+  const size_t tail = tail_.load(std::memory_order_acquire);
+  return tail - head;
+}
+
+template <typename T>
+bool SpscRing<T>::TryPush(const T& value) {
+  return TryEmplace(value);
+}
+
+template <typename T>
+bool SpscRing<T>::TryPush(T&& value) {
+  return TryEmplace(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+bool SpscRing<T>::TryEmplace(Args&&... args) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - cached_head_ == data_.Capacity()) {
+    cached_head_ = head_.load(std::memory_order_acquire);
+    if (tail - cached_head_ == data_.Capacity()) {
+      return false;
+    }
+  }
+  new (data_ + (tail & mask_)) T(std::forward<Args>(args)...);
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool SpscRing<T>::TryPop(T& value) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (head == cached_tail_) {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    if (head == cached_tail_) {
+      return false;
+    }
+  }
+  T* slot = data_ + (head & mask_);
+  value = std::move(*slot);
+  std::destroy_at(slot);
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+size_t SpscRing<T>::RoundUpToPowerOfTwo(size_t n) noexcept {
+  size_t result = 1;
+  while (result < n) {
+    result *= 2;
+  }
+  return result;
+}
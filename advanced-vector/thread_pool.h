@@ -0,0 +1,276 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "ring_vector.h"
+#include "vector.h"
+
+// Пул потоков с перехватом задач. У каждого участника своя очередь:
+// владелец кладёт и забирает задачи с конца (последняя созданная задача ещё
+// горячая в кэше), а свободные потоки крадут с начала чужих очередей самые
+// старые, обычно самые крупные задачи. Очередь 0 принадлежит потокам вне
+// пула; поток, ожидающий TaskGroup, сам выполняет задачи, поэтому пул с
+// параллелизмом n запускает n - 1 рабочих потоков.
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t concurrency = DefaultConcurrency());
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  // К моменту разрушения все задачи должны быть выполнены
+  ~ThreadPool();
+
+  static size_t DefaultConcurrency() noexcept;
+
+  // Число потоков, выполняющих задачи, включая ожидающий поток
+  size_t Concurrency() const noexcept;
+  // Задача не должна выпускать исключения; задачи, которые могут их
+  // выбрасывать, запускаются через TaskGroup
+  void Submit(std::function<void()> task);
+  // Выполняет одну задачу из своей или чужой очереди; false, если задач нет
+  bool RunPendingTask();
+
+ private:
+  friend class TaskGroup;
+
+  struct Queue {
+    std::mutex mutex;
+    RingVector<std::function<void()>> tasks;
+  };
+
+  // Засыпает вместе со свободными рабочими потоками, пока в очередях нет
+  // задач и done() возвращает false
+  template <typename Predicate>
+  void SleepUntil(Predicate done);
+  // Будит потоки, спящие в SleepUntil, чтобы они перепроверили условие
+  void WakeSleepers() noexcept;
+  void Shutdown() noexcept;
+  void WorkerLoop(size_t index);
+  size_t CurrentQueue() const noexcept;
+  bool TryPop(size_t index, std::function<void()>& task);
+
+  std::unique_ptr<Queue[]> queues_;
+  size_t concurrency_;
+  Vector<std::thread> workers_;
+
+  std::atomic<size_t> queued_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stop_ = false;
+
+  static inline thread_local const ThreadPool* current_pool_ = nullptr;
+  static inline thread_local size_t current_queue_ = 0;
+};
+
+// Группа задач с ожиданием завершения. Wait выполняет задачи пула, пока
+// группа не опустеет, поэтому задачи могут сами создавать группы и ждать их.
+// Первое исключение из задач группы перебрасывается из Wait.
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool& pool) noexcept;
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+  ~TaskGroup();
+
+  template <typename F>
+  void Run(F&& task);
+  void Wait();
+
+ private:
+  void WaitPending() noexcept;
+
+  ThreadPool& pool_;
+  std::atomic<size_t> pending_{0};
+  std::mutex error_mutex_;
+  std::exception_ptr error_;
+};
+
+inline ThreadPool::ThreadPool(size_t concurrency)
+    : queues_(std::make_unique<Queue[]>(std::max<size_t>(concurrency, 1))),
+      concurrency_(std::max<size_t>(concurrency, 1)) {
+  workers_.Reserve(concurrency_ - 1);
+  try {
+    for (size_t i = 1; i < concurrency_; ++i) {
+      workers_.EmplaceBack([this, i] {
+        WorkerLoop(i);
+      });
+    }
+  } catch (...) {
+    Shutdown();
+    throw;
+  }
+}
+
+inline ThreadPool::~ThreadPool() {
+  Shutdown();
+}
+
+inline void ThreadPool::Shutdown() noexcept {
+  {
+    std::lock_guard guard(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  workers_.Clear();
+}
+
+inline size_t ThreadPool::DefaultConcurrency() noexcept {
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+inline size_t ThreadPool::Concurrency() const noexcept {
+  return concurrency_;
+}
+
+inline void ThreadPool::Submit(std::function<void()> task) {
+  Queue& queue = queues_[CurrentQueue()];
+  {
+    std::lock_guard guard(queue.mutex);
+    queue.tasks.PushBack(std::move(task));
+  }
+  queued_.fetch_add(1, std::memory_order_release);
+  {
+    // Пустая критическая секция не даёт уведомлению проскочить между
+    // проверкой условия и засыпанием рабочего потока
+    std::lock_guard guard(sleep_mutex_);
+  }
+  wake_.notify_one();
+}
+
+inline bool ThreadPool::RunPendingTask() {
+  std::function<void()> task;
+  if (!TryPop(CurrentQueue(), task)) {
+    return false;
+  }
+  task();
+  return true;
+}
+
+inline void ThreadPool::WorkerLoop(size_t index) {
+  current_pool_ = this;
+  current_queue_ = index;
+  std::function<void()> task;
+  while (true) {
+    if (TryPop(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock lock(sleep_mutex_);
+    wake_.wait(lock, [this] {
+      return stop_ || queued_.load(std::memory_order_acquire) != 0;
+    });
+    if (stop_ && queued_.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+
+template <typename Predicate>
+void ThreadPool::SleepUntil(Predicate done) {
+  std::unique_lock lock(sleep_mutex_);
+  wake_.wait(lock, [this, &done] {
+    return queued_.load(std::memory_order_acquire) != 0 || done();
+  });
+}
+
+inline void ThreadPool::WakeSleepers() noexcept {
+  {
+    // См. комментарий в Submit
+    std::lock_guard guard(sleep_mutex_);
+  }
+  wake_.notify_all();
+}
+
+inline size_t ThreadPool::CurrentQueue() const noexcept {
+  return current_pool_ == this ? current_queue_ : 0;
+}
+
+inline bool ThreadPool::TryPop(size_t index, std::function<void()>& task) {
+  if (queued_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  {
+    Queue& own = queues_[index];
+    std::lock_guard guard(own.mutex);
+    if (own.tasks.Size() != 0) {
+      task = std::move(own.tasks.Back());
+      own.tasks.PopBack();
+      queued_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  for (size_t i = 1; i < concurrency_; ++i) {
+    Queue& victim = queues_[(index + i) % concurrency_];
+    std::lock_guard guard(victim.mutex);
+    if (victim.tasks.Size() != 0) {
+      task = std::move(victim.tasks.Front());
+      victim.tasks.PopFront();
+      queued_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+inline TaskGroup::TaskGroup(ThreadPool& pool) noexcept : pool_(pool) {}
+
+inline TaskGroup::~TaskGroup() {
+  WaitPending();
+}
+
+template <typename F>
+void TaskGroup::Run(F&& task) {
+  pending_.fetch_add(1, std::memory_order_relaxed);
+  try {
+    pool_.Submit([this, task = std::forward<F>(task)]() mutable {
+      try {
+        task();
+      } catch (...) {
+        std::lock_guard guard(error_mutex_);
+        if (!error_) {
+          error_ = std::current_exception();
+        }
+      }
+      // Уменьшение счётчика — последнее обращение к группе: после него
+      // Wait может вернуться и группа разрушиться, поэтому ссылка на пул
+      // берётся заранее
+      ThreadPool& pool = pool_;
+      if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        pool.WakeSleepers();
+      }
+    });
+  } catch (...) {
+    pending_.fetch_sub(1, std::memory_order_relaxed);
+    throw;
+  }
+}
+
+inline void TaskGroup::Wait() {
+  WaitPending();
+  if (error_) {
+    std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+}
+
+inline void TaskGroup::WaitPending() noexcept {
+  // Когда красть нечего, оставшиеся задачи группы уже выполняются другими
+  // потоками. Ожидающий засыпает до завершения последней из них или до
+  // появления новых задач, которые он может выполнить сам
+  while (pending_.load(std::memory_order_acquire) != 0) {
+    if (!pool_.RunPendingTask()) {
+      pool_.SleepUntil([this] {
+        return pending_.load(std::memory_order_acquire) == 0;
+      });
+    }
+  }
+}
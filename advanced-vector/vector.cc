@@ -0,0 +1,17 @@
+// Явные инстанцирования Vector для сборки с ADVANCED_VECTOR_EXTERN_TEMPLATES.
+// Список типов должен совпадать с объявлениями extern template в vector.h.
+#include "vector.h"
+
+#include <cstdint>
+#include <string>
+
+template class RawMemory<char>;
+template class RawMemory<int>;
+template class RawMemory<double>;
+template class RawMemory<uint64_t>;
+template class RawMemory<std::string>;
+template class Vector<char>;
+template class Vector<int>;
+template class Vector<double>;
+template class Vector<uint64_t>;
+template class Vector<std::string>;
@@ -4,13 +4,74 @@
 #include <cstdlib>
 #include <memory>
 #include <new>
+#include <type_traits>
 #include <utility>
 
+#ifdef ADVANCED_VECTOR_STATS
+#include <atomic>
+#endif
+
+#include "buffer_cache.h"
+
+#ifdef ADVANCED_VECTOR_DEFERRED_DESTRUCTION
+#include "deferred_destruction.h"
+#endif
+
+// Статистика работы Vector с памятью. Счётчики собираются только при
+// компиляции с ADVANCED_VECTOR_STATS, иначе инструментация не занимает места
+// в объекте, не выполняет кода и все значения равны нулю. Оператор вывода
+// в поток объявлен в vector_stats.h.
+struct VectorStats {
+  size_t reallocations = 0;
+  size_t bytes_allocated = 0;
+  size_t bytes_freed = 0;
+  size_t moved_elements = 0;
+  size_t copied_elements = 0;
+  // Наибольшая ёмкость одного буфера в байтах
+  size_t peak_capacity = 0;
+  // Выделенная, но не занятая элементами память
+  size_t slack_bytes = 0;
+};
+
+// Суммарная статистика всех векторов программы
+VectorStats GlobalVectorStats() noexcept;
+void ResetGlobalVectorStats() noexcept;
+
+#ifdef ADVANCED_VECTOR_STATS
+namespace vector_stats {
+
+struct GlobalCounters {
+  std::atomic<size_t> reallocations{0};
+  std::atomic<size_t> bytes_allocated{0};
+  std::atomic<size_t> bytes_freed{0};
+  std::atomic<size_t> moved_elements{0};
+  std::atomic<size_t> copied_elements{0};
+  std::atomic<size_t> peak_capacity{0};
+  std::atomic<size_t> live_size_bytes{0};
+};
+
+inline GlobalCounters global;
+
+inline void UpdatePeak(std::atomic<size_t>& peak, size_t value) noexcept {
+  size_t current = peak.load(std::memory_order_relaxed);
+  while (current < value &&
+         !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace vector_stats
+#endif
+
 template <typename T>
 class RawMemory {
  public:
+  // Освобождает буфер ёмкостью capacity элементов
+  using Deleter = void (*)(T* buffer, size_t capacity);
+
   RawMemory() = default;
   explicit RawMemory(size_t capacity);
+  // Принимает во владение чужой буфер, который будет освобождён через deleter
+  RawMemory(T* buffer, size_t capacity, Deleter deleter) noexcept;
 
   RawMemory(const RawMemory&) = delete;
   RawMemory& operator=(const RawMemory&) = delete;
@@ -28,13 +89,67 @@ class RawMemory {
   const T* GetAddress() const noexcept;
   T* GetAddress() noexcept;
   size_t Capacity() const;
+  Deleter GetDeleter() const noexcept;
+  // Отдаёт буфер вызывающему, который должен освободить его через GetDeleter()
+  T* Release() noexcept;
+
+  // Освобождает буфер, выделенный RawMemory(size_t)
+  static void DefaultDeleter(T* buffer, size_t capacity);
 
  private:
   static T* Allocate(size_t n);
-  static void Deallocate(T* buf) noexcept;
 
   T* buffer_ = nullptr;
   size_t capacity_ = 0;
+  Deleter deleter_ = &DefaultDeleter;
+};
+
+namespace vector_detail {
+
+// Элементы переносятся в новый буфер перемещением, только если оно не бросает
+// исключений или копирование невозможно. Иначе они копируются, и исключение
+// оставляет исходные элементы нетронутыми.
+//
+// Контейнеры над RawMemory создают новый элемент в новом буфере до переноса
+// старых: аргументы Emplace могут ссылаться на элементы того же контейнера.
+template <typename T>
+inline constexpr bool kRelocateByMove =
+    std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>;
+
+template <typename InputIt, typename OutputIt>
+void UninitMoveOrCopy(InputIt first, InputIt last, OutputIt d_first) {
+  // Тип элемента выводится без std::iterator_traits, чтобы не подключать
+  // тяжёлый <iterator> в каждую единицу трансляции
+  if constexpr (kRelocateByMove<std::decay_t<decltype(*first)>>) {
+    std::uninitialized_move(first, last, d_first);
+  } else {
+    std::uninitialized_copy(first, last, d_first);
+  }
+}
+
+// То же, но при исключении дополнительно разрушает [dy_first, dy_last)
+template <typename InputIt, typename OutputIt>
+void TryUninitMoveOrCopy(InputIt first, InputIt last, OutputIt d_first,
+                         OutputIt dy_first, OutputIt dy_last) {
+  try {
+    UninitMoveOrCopy(first, last, d_first);
+  } catch (...) {
+    std::destroy(dy_first, dy_last);
+    throw;
+  }
+}
+
+}  // namespace vector_detail
+
+// Буфер, отданный Vector::Release: элементы [data, data + size) живы,
+// освобождать память нужно вызовом deleter(data, capacity) после их
+// разрушения
+template <typename T>
+struct VectorBuffer {
+  T* data = nullptr;
+  size_t size = 0;
+  size_t capacity = 0;
+  typename RawMemory<T>::Deleter deleter = nullptr;
 };
 
 template <typename T>
@@ -67,8 +182,18 @@ class Vector {
   template <typename... Args>
   T& EmplaceBack(Args&&... args);
   void PopBack();
+  void Clear() noexcept;
   T& Back() noexcept;
   void Swap(Vector& other) noexcept;
+  VectorStats Stats() const noexcept;
+
+  // Отдаёт буфер вместе с элементами без копирования; вектор становится пустым
+  VectorBuffer<T> Release() noexcept;
+  // Создаёт вектор поверх чужого буфера, в котором уже сконструированы size
+  // элементов. Буфер освобождается вызовом deleter(data, capacity), в том
+  // числе при перевыделении памяти вектором
+  static Vector Adopt(T* data, size_t size, size_t capacity,
+                      typename RawMemory<T>::Deleter deleter) noexcept;
 
   iterator begin() noexcept;
   iterator end() noexcept;
@@ -78,24 +203,37 @@ class Vector {
   const_iterator cend() const noexcept;
 
  private:
-  template <typename InputIt, typename OutputIt>
-  void MoveOrCopy(InputIt first, InputIt last, OutputIt d_first);
-  template <typename InputIt, typename OutputIt>
-  void UninitMoveOrCopy(InputIt first, InputIt last, OutputIt d_first);
-  template <typename InputIt, typename OutputIt>
-  void TryUninitMoveOrCopy(InputIt first, InputIt last, OutputIt d_first,
-                           OutputIt dy_first, OutputIt dy_last);
   template <typename InOutIt>
-  void MoveOrCopyBackward(InOutIt first, InOutIt last);
+  void ShiftLeft(InOutIt first, InOutIt last);
+  template <typename InOutIt>
+  void ShiftRight(InOutIt first, InOutIt last);
+  // Передаёт буфер DeferredDestruction, если он достаточно велик. Без
+  // ADVANCED_VECTOR_DEFERRED_DESTRUCTION всегда возвращает false, и vector.h
+  // не подключает заголовки потоков
+  bool TryDeferDestruction() noexcept;
+  void TrackAllocation(size_t old_capacity, size_t new_capacity) noexcept;
+  void TrackOwnAllocation(size_t old_capacity, size_t new_capacity) noexcept;
+  void TrackPeak() noexcept;
+  void TrackRelocation(size_t count) noexcept;
+  void TrackSize(size_t old_size, size_t new_size) noexcept;
 
   RawMemory<T> data_;
   size_t size_ = 0;
+#ifdef ADVANCED_VECTOR_STATS
+  VectorStats stats_;
+#endif
 };
 
 template <typename T>
 RawMemory<T>::RawMemory(size_t capacity)
     : buffer_(Allocate(capacity)), capacity_(capacity) {}
 
+template <typename T>
+RawMemory<T>::RawMemory(T* buffer, size_t capacity, Deleter deleter) noexcept
+    : buffer_(buffer), capacity_(capacity), deleter_(deleter) {
+  assert(deleter != nullptr);
+}
+
 template <typename T>
 RawMemory<T>::RawMemory(RawMemory&& other) noexcept {
   Swap(other);
@@ -111,7 +249,9 @@ RawMemory<T>& RawMemory<T>::operator=(RawMemory&& rhs) noexcept {
 
 template <typename T>
 RawMemory<T>::~RawMemory() {
-  Deallocate(buffer_);
+  if (buffer_ != nullptr) {
+    deleter_(buffer_, capacity_);
+  }
 }
 
 template <typename T>
@@ -142,6 +282,7 @@ template <typename T>
 void RawMemory<T>::Swap(RawMemory& other) noexcept {
   std::swap(buffer_, other.buffer_);
   std::swap(capacity_, other.capacity_);
+  std::swap(deleter_, other.deleter_);
 }
 
 template <typename T>
@@ -161,28 +302,46 @@ size_t RawMemory<T>::Capacity() const {
 
 template <typename T>
 T* RawMemory<T>::Allocate(size_t n) {
-  return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+  return n != 0 ? static_cast<T*>(BufferCache::Allocate(n * sizeof(T)))
+                : nullptr;
+}
+
+template <typename T>
+typename RawMemory<T>::Deleter RawMemory<T>::GetDeleter() const noexcept {
+  return deleter_;
+}
+
+template <typename T>
+T* RawMemory<T>::Release() noexcept {
+  capacity_ = 0;
+  deleter_ = &DefaultDeleter;
+  return std::exchange(buffer_, nullptr);
 }
 
 template <typename T>
-void RawMemory<T>::Deallocate(T* buf) noexcept {
-  operator delete(buf);
+void RawMemory<T>::DefaultDeleter(T* buffer, size_t capacity) {
+  BufferCache::Deallocate(buffer, capacity * sizeof(T));
 }
 
 template <typename T>
 Vector<T>::Vector(size_t size) : data_{size}, size_{size} {
   std::uninitialized_value_construct(begin(), end());
+  TrackAllocation(0, size);
+  TrackSize(0, size);
 }
 
 template <typename T>
 Vector<T>::Vector(const Vector& other)
     : data_{other.size_}, size_{other.size_} {
   std::uninitialized_copy(other.begin(), other.end(), begin());
+  TrackAllocation(0, size_);
+  TrackSize(0, size_);
 }
 
 template <typename T>
 Vector<T>::Vector(Vector&& other) noexcept : data_{std::move(other.data_)} {
   std::swap(size_, other.size_);
+  TrackPeak();
 }
 
 template <typename T>
@@ -191,8 +350,11 @@ Vector<T>& Vector<T>::operator=(const Vector<T>& rhs) {
     return *this;
   }
   if (rhs.size_ > data_.Capacity()) {
+    const size_t old_capacity = data_.Capacity();
     Vector rhs_copy(rhs);
     Swap(rhs_copy);
+    // Глобальные счётчики уже учтены конструктором и деструктором rhs_copy
+    TrackOwnAllocation(old_capacity, data_.Capacity());
   } else {
     if (rhs.size_ < size_) {
       std::copy(rhs.cbegin(), rhs.cend(), begin());
@@ -201,6 +363,7 @@ Vector<T>& Vector<T>::operator=(const Vector<T>& rhs) {
       std::copy(rhs.cbegin(), rhs.cbegin() + size_, begin());
       std::uninitialized_copy_n(rhs.cbegin() + size_, rhs.size_ - size_, end());
     }
+    TrackSize(size_, rhs.size_);
     size_ = rhs.size_;
   }
   return *this;
@@ -216,7 +379,11 @@ Vector<T>& Vector<T>::operator=(Vector<T>&& rhs) noexcept {
 
 template <typename T>
 Vector<T>::~Vector() {
-  std::destroy(begin(), end());
+  TrackSize(size_, 0);
+  TrackAllocation(data_.Capacity(), 0);
+  if (!TryDeferDestruction()) {
+    std::destroy(begin(), end());
+  }
 }
 
 template <typename T>
@@ -246,19 +413,26 @@ void Vector<T>::Reserve(size_t new_capacity) {
     return;
   }
   RawMemory<T> new_data{new_capacity};
-  UninitMoveOrCopy(begin(), end(), new_data.GetAddress());
+  vector_detail::UninitMoveOrCopy(begin(), end(), new_data.GetAddress());
+  TrackRelocation(size_);
   std::destroy(begin(), end());
+  TrackAllocation(data_.Capacity(), new_capacity);
   data_.Swap(new_data);
 }
 
 template <typename T>
 void Vector<T>::Resize(size_t new_size) {
   if (new_size > size_) {
-    Reserve(new_size);
+    // Рост, как и в EmplaceBack, геометрический, иначе серия Resize на один
+    // элемент перевыделяла бы память каждый раз
+    if (new_size > data_.Capacity()) {
+      Reserve(std::max(new_size, size_ * 2));
+    }
     std::uninitialized_value_construct_n(end(), new_size - size_);
   } else {
     std::destroy_n(begin() + new_size, size_ - new_size);
   }
+  TrackSize(size_, new_size);
   size_ = new_size;
 }
 
@@ -285,22 +459,26 @@ typename Vector<T>::iterator Vector<T>::Emplace(const_iterator pos,
     auto new_begin = new_data.GetAddress();
     auto new_pos = new (new_data.GetAddress() + distance_from_begin)
         T(std::forward<Args>(args)...);
-    TryUninitMoveOrCopy(begin(), pos_non_const, new_begin, new_pos,
-                        new_pos + 1);
-    TryUninitMoveOrCopy(pos_non_const, end(), new_pos + 1, new_begin,
-                        new_pos + 1);
+    vector_detail::TryUninitMoveOrCopy(begin(), pos_non_const, new_begin,
+                                       new_pos, new_pos + 1);
+    vector_detail::TryUninitMoveOrCopy(pos_non_const, end(), new_pos + 1,
+                                       new_begin, new_pos + 1);
+    TrackRelocation(size_);
     std::destroy(begin(), end());
+    TrackAllocation(data_.Capacity(), new_data.Capacity());
     data_.Swap(new_data);
+    TrackSize(size_, size_ + 1);
     ++size_;
     return new_pos;
   }
   if (pos != end()) {
     T element(std::forward<Args>(args)...);
-    MoveOrCopyBackward(pos_non_const, end());
+    ShiftRight(pos_non_const, end());
     *pos_non_const = std::move(element);
   } else {
     new (end()) T(std::forward<Args>(args)...);
   }
+  TrackSize(size_, size_ + 1);
   ++size_;
   return pos_non_const;
 }
@@ -309,8 +487,9 @@ template <typename T>
 typename Vector<T>::iterator Vector<T>::Erase(const_iterator pos) {
   assert(pos >= begin() && pos < end());
   auto pos_non_const = const_cast<iterator>(pos);
-  MoveOrCopy(pos_non_const + 1, end(), pos_non_const);
-    std::destroy_at(end() - 1);
+  ShiftLeft(pos_non_const, end());
+  std::destroy_at(end() - 1);
+  TrackSize(size_, size_ - 1);
   --size_;
   return pos_non_const;
 }
@@ -331,12 +510,15 @@ T& Vector<T>::EmplaceBack(Args&&... args) {
   if (size_ == data_.Capacity()) {
     RawMemory<T> new_data{size_ == 0 ? 1 : size_ * 2};
     new (new_data.GetAddress() + size_) T(std::forward<Args>(args)...);
-    UninitMoveOrCopy(begin(), end(), new_data.GetAddress());
+    vector_detail::UninitMoveOrCopy(begin(), end(), new_data.GetAddress());
+    TrackRelocation(size_);
     std::destroy(begin(), end());
+    TrackAllocation(data_.Capacity(), new_data.Capacity());
     data_.Swap(new_data);
   } else {
     new (end()) T(std::forward<Args>(args)...);
   }
+  TrackSize(size_, size_ + 1);
   ++size_;
   return Back();
 }
@@ -344,10 +526,18 @@ T& Vector<T>::EmplaceBack(Args&&... args) {
 template <typename T>
 void Vector<T>::PopBack() {
   assert(size_ != 0);
+  TrackSize(size_, size_ - 1);
   --size_;
   std::destroy_at(end());
 }
 
+template <typename T>
+void Vector<T>::Clear() noexcept {
+  std::destroy(begin(), end());
+  TrackSize(size_, 0);
+  size_ = 0;
+}
+
 template <typename T>
 T& Vector<T>::Back() noexcept {
   return *(end() - 1);
@@ -357,57 +547,145 @@ template <typename T>
 void Vector<T>::Swap(Vector& other) noexcept {
   data_.Swap(other.data_);
   std::swap(size_, other.size_);
+  // Статистика остаётся у объекта, а не переходит вместе с буфером
+  TrackPeak();
+  other.TrackPeak();
 }
 
 template <typename T>
-template <typename InputIt, typename OutputIt>
-void Vector<T>::MoveOrCopy(InputIt first, InputIt last, OutputIt d_first) {
-  if constexpr (std::is_nothrow_move_constructible_v<T> ||
-                !std::is_copy_constructible_v<T>) {
-    std::move(first, last, d_first);
-  } else {
-    std::copy(first, last, d_first);
-  }
+VectorStats Vector<T>::Stats() const noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+  VectorStats stats = stats_;
+  stats.slack_bytes = (data_.Capacity() - size_) * sizeof(T);
+  return stats;
+#else
+  return {};
+#endif
 }
 
 template <typename T>
-template <typename InputIt, typename OutputIt>
-void Vector<T>::UninitMoveOrCopy(InputIt first, InputIt last,
-                                 OutputIt d_first) {
-  if constexpr (std::is_nothrow_move_constructible_v<T> ||
-                !std::is_copy_constructible_v<T>) {
-    std::uninitialized_move(first, last, d_first);
-  } else {
-    std::uninitialized_copy(first, last, d_first);
-  }
+VectorBuffer<T> Vector<T>::Release() noexcept {
+  TrackSize(size_, 0);
+  TrackAllocation(data_.Capacity(), 0);
+  VectorBuffer<T> buffer;
+  buffer.size = std::exchange(size_, 0);
+  buffer.capacity = data_.Capacity();
+  buffer.deleter = data_.GetDeleter();
+  buffer.data = data_.Release();
+  return buffer;
 }
 
 template <typename T>
-template <typename InputIt, typename OutputIt>
-void Vector<T>::TryUninitMoveOrCopy(InputIt first, InputIt last,
-                                    OutputIt d_first, OutputIt dy_first,
-                                    OutputIt dy_last) {
-  try {
-    UninitMoveOrCopy(first, last, d_first);
-  } catch (...) {
-    std::destroy(dy_first, dy_last);
-    throw;
-  }
+Vector<T> Vector<T>::Adopt(T* data, size_t size, size_t capacity,
+                           typename RawMemory<T>::Deleter deleter) noexcept {
+  assert(size <= capacity);
+  Vector result;
+  RawMemory<T> memory(data, capacity, deleter);
+  result.data_.Swap(memory);
+  result.size_ = size;
+  result.TrackAllocation(0, capacity);
+  result.TrackSize(0, size);
+  return result;
 }
 
 template <typename T>
 template <typename InOutIt>
-void Vector<T>::MoveOrCopyBackward(InOutIt first, InOutIt last) {
-  if constexpr (std::is_nothrow_move_constructible_v<T> ||
-                std::is_nothrow_move_assignable_v<T> ||
-                !std::is_copy_constructible_v<T> ||
-                !std::is_copy_assignable_v<T>) {
-    std::uninitialized_move(last - 1, last, last);
-    std::move_backward(first, last - 1, last);
+void Vector<T>::ShiftLeft(InOutIt first, InOutIt last) {
+  // Сдвиг внутри буфера перезаписывает живые элементы и не даёт строгой
+  // гарантии ни при копировании, ни при перемещении, поэтому, как и
+  // std::vector, всегда перемещаем
+  std::move(first + 1, last, first);
+}
+
+template <typename T>
+template <typename InOutIt>
+void Vector<T>::ShiftRight(InOutIt first, InOutIt last) {
+  // См. комментарий к ShiftLeft
+  std::uninitialized_move(last - 1, last, last);
+  std::move_backward(first, last - 1, last);
+}
+
+template <typename T>
+bool Vector<T>::TryDeferDestruction() noexcept {
+#ifdef ADVANCED_VECTOR_DEFERRED_DESTRUCTION
+  if (!DeferredDestruction::ShouldDefer(data_.Capacity() * sizeof(T)) ||
+      !DeferredDestruction::Defer(data_.GetAddress(), size_, data_.Capacity(),
+                                  data_.GetDeleter())) {
+    return false;
+  }
+  data_.Release();
+  size_ = 0;
+  return true;
+#else
+  return false;
+#endif
+}
+
+template <typename T>
+void Vector<T>::TrackAllocation([[maybe_unused]] size_t old_capacity,
+                                [[maybe_unused]] size_t new_capacity) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+  using vector_stats::global;
+  TrackOwnAllocation(old_capacity, new_capacity);
+  const size_t allocated = new_capacity * sizeof(T);
+  const size_t freed = old_capacity * sizeof(T);
+  const size_t reallocations = old_capacity != 0 && new_capacity != 0;
+  global.reallocations.fetch_add(reallocations, std::memory_order_relaxed);
+  global.bytes_allocated.fetch_add(allocated, std::memory_order_relaxed);
+  global.bytes_freed.fetch_add(freed, std::memory_order_relaxed);
+  vector_stats::UpdatePeak(global.peak_capacity, allocated);
+#endif
+}
+
+template <typename T>
+void Vector<T>::TrackOwnAllocation(
+    [[maybe_unused]] size_t old_capacity,
+    [[maybe_unused]] size_t new_capacity) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+  // Перевыделением считается только замена уже существующего буфера
+  stats_.reallocations += old_capacity != 0 && new_capacity != 0;
+  stats_.bytes_allocated += new_capacity * sizeof(T);
+  stats_.bytes_freed += old_capacity * sizeof(T);
+  stats_.peak_capacity =
+      std::max(stats_.peak_capacity, new_capacity * sizeof(T));
+#endif
+}
+
+template <typename T>
+void Vector<T>::TrackPeak() noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+  stats_.peak_capacity =
+      std::max(stats_.peak_capacity, data_.Capacity() * sizeof(T));
+#endif
+}
+
+template <typename T>
+void Vector<T>::TrackRelocation([[maybe_unused]] size_t count) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+  using vector_stats::global;
+  if constexpr (vector_detail::kRelocateByMove<T>) {
+    stats_.moved_elements += count;
+    global.moved_elements.fetch_add(count, std::memory_order_relaxed);
+  } else {
+    stats_.copied_elements += count;
+    global.copied_elements.fetch_add(count, std::memory_order_relaxed);
+  }
+#endif
+}
+
+template <typename T>
+void Vector<T>::TrackSize([[maybe_unused]] size_t old_size,
+                          [[maybe_unused]] size_t new_size) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+  auto& live_size_bytes = vector_stats::global.live_size_bytes;
+  if (new_size > old_size) {
+    live_size_bytes.fetch_add((new_size - old_size) * sizeof(T),
+                              std::memory_order_relaxed);
   } else {
-    std::uninitialized_copy(last - 1, last, last);
-    std::copy_backward(first, last - 1, last);
+    live_size_bytes.fetch_sub((old_size - new_size) * sizeof(T),
+                              std::memory_order_relaxed);
   }
+#endif
 }
 
 template <typename T>
@@ -438,4 +716,58 @@ typename Vector<T>::const_iterator Vector<T>::cbegin() const noexcept {
 template <typename T>
 typename Vector<T>::const_iterator Vector<T>::cend() const noexcept {
   return end();
-}
\ No newline at end of file
+}
+
+inline VectorStats GlobalVectorStats() noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+  using vector_stats::global;
+  VectorStats stats;
+  stats.reallocations = global.reallocations.load(std::memory_order_relaxed);
+  stats.bytes_allocated = global.bytes_allocated.load(std::memory_order_relaxed);
+  stats.bytes_freed = global.bytes_freed.load(std::memory_order_relaxed);
+  stats.moved_elements = global.moved_elements.load(std::memory_order_relaxed);
+  stats.copied_elements = global.copied_elements.load(std::memory_order_relaxed);
+  stats.peak_capacity = global.peak_capacity.load(std::memory_order_relaxed);
+  const size_t live_bytes = stats.bytes_allocated - stats.bytes_freed;
+  const size_t live_size_bytes =
+      global.live_size_bytes.load(std::memory_order_relaxed);
+  stats.slack_bytes = live_bytes > live_size_bytes ? live_bytes - live_size_bytes : 0;
+  return stats;
+#else
+  return {};
+#endif
+}
+
+inline void ResetGlobalVectorStats() noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+  using vector_stats::global;
+  global.reallocations.store(0, std::memory_order_relaxed);
+  global.bytes_allocated.store(0, std::memory_order_relaxed);
+  global.bytes_freed.store(0, std::memory_order_relaxed);
+  global.moved_elements.store(0, std::memory_order_relaxed);
+  global.copied_elements.store(0, std::memory_order_relaxed);
+  global.peak_capacity.store(0, std::memory_order_relaxed);
+  global.live_size_bytes.store(0, std::memory_order_relaxed);
+#endif
+}
+
+// Часто используемые специализации инстанцируются один раз в vector.cc.
+// Единицы трансляции, собранные с ADVANCED_VECTOR_EXTERN_TEMPLATES, не
+// инстанцируют их сами и должны компоноваться с vector.o, собранным с теми же
+// значениями ADVANCED_VECTOR_STATS и ADVANCED_VECTOR_DEFERRED_DESTRUCTION. Без
+// макроса vector.h остаётся полностью заголовочным.
+#ifdef ADVANCED_VECTOR_EXTERN_TEMPLATES
+#include <cstdint>
+#include <string>
+
+extern template class RawMemory<char>;
+extern template class RawMemory<int>;
+extern template class RawMemory<double>;
+extern template class RawMemory<uint64_t>;
+extern template class RawMemory<std::string>;
+extern template class Vector<char>;
+extern template class Vector<int>;
+extern template class Vector<double>;
+extern template class Vector<uint64_t>;
+extern template class Vector<std::string>;
+#endif
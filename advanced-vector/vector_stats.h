@@ -0,0 +1,16 @@
+#pragma once
+#include <ostream>
+
+#include "vector.h"
+
+// Вывод статистики вынесен из vector.h, чтобы программы, которые её не
+// печатают, не подключали <ostream>
+inline std::ostream& operator<<(std::ostream& out, const VectorStats& stats) {
+  return out << "reallocations: " << stats.reallocations
+             << ", bytes allocated: " << stats.bytes_allocated
+             << ", bytes freed: " << stats.bytes_freed
+             << ", moved elements: " << stats.moved_elements
+             << ", copied elements: " << stats.copied_elements
+             << ", peak capacity: " << stats.peak_capacity
+             << ", slack bytes: " << stats.slack_bytes;
+}